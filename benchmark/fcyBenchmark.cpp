@@ -0,0 +1,909 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyBenchmark.cpp
+/// @brief fcylib性能基准与回归检测
+/// @note  用法：fcyBenchmark [--quick] [--filter 子串] [--out 结果.json]
+///                         [--baseline 基准.json] [--threshold 0.1] [--repeat N] [--min-time 秒]
+///        计时前先校验各被测函数的结果，校验失败时返回非0。
+///        指定--baseline时与基准结果逐项比较，存在超过阈值的变慢时返回非0。
+////////////////////////////////////////////////////////////////////////////////
+#include "fcyMemPool.h"
+#include "fcyMisc/fcyHash.h"
+#include "fcyMisc/fcyRandom.h"
+#include "fcyMisc/fcyStopWatch.h"
+#include "fcyMisc/fcyStringHelper.h"
+#include "fcyMisc/fcyStringConvCache.h"
+#include "fcyMisc/fcyHistogram.h"
+#include "fcyMisc/fcyProfiler.h"
+#include "fcyMisc/fcyPerfCounter.h"
+#include "fcyParser/fcyPathParser.h"
+#include "fcyParser/fcyPathCache.h"
+#include "fcyParser/fcyPathIndex.h"
+#include "fcyParser/fcyTextTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	/// @brief 防止计算结果被优化掉
+	volatile uint64_t g_Sink = 0;
+
+	inline void Consume(uint64_t Value)
+	{
+		g_Sink = g_Sink + Value;
+	}
+
+	/// @brief 单项结果
+	struct BenchResult
+	{
+		string Name;         ///< @brief 名称
+		double NsPerOp;      ///< @brief 每次操作的纳秒数
+		uint64_t Iterations; ///< @brief 每轮迭代次数
+		double BytesPerOp;   ///< @brief 每次操作处理的字节数，0表示不适用
+	};
+
+	/// @brief 运行配置
+	struct BenchConfig
+	{
+		double MinTime = 0.2;   ///< @brief 每轮最短时间（秒）
+		uint32_t Repeat = 5;    ///< @brief 轮数，取最快一轮
+		string Filter;          ///< @brief 名称过滤
+		string OutPath;         ///< @brief 结果输出路径
+		string BaselinePath;    ///< @brief 基准结果路径
+		double Threshold = 0.1; ///< @brief 回归阈值
+		bool Quick = false;     ///< @brief 快速模式
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief 基准运行器
+	/// @note  先按目标时间估算迭代次数，再运行多轮取最快一轮
+	////////////////////////////////////////////////////////////////////////////////
+	class BenchRunner
+	{
+	private:
+		const BenchConfig& m_Config;
+		vector<BenchResult> m_Results;
+	public:
+		const vector<BenchResult>& GetResults()const { return m_Results; }
+
+		/// @brief     运行一项基准
+		/// @param[in] Name       名称
+		/// @param[in] BytesPerOp 每次操作处理的字节数
+		/// @param[in] Func       基准函数，参数为迭代次数
+		void Run(const string& Name, double BytesPerOp, const function<void(uint64_t)>& Func)
+		{
+			if (!m_Config.Filter.empty() && Name.find(m_Config.Filter) == string::npos)
+				return;
+
+			// 估算迭代次数
+			uint64_t tIterations = 1;
+			double tTime = 0.;
+			for (;;)
+			{
+				fcyStopWatch tWatch;
+				Func(tIterations);
+				tTime = tWatch.GetElapsed();
+				if (tTime >= m_Config.MinTime * 0.1 || tIterations >= (1ull << 40))
+					break;
+				tIterations *= tTime > 0. ? min<uint64_t>(100, (uint64_t)(m_Config.MinTime * 0.2 / tTime) + 2) : 100;
+			}
+			tIterations = max<uint64_t>(1, (uint64_t)(double(tIterations) * m_Config.MinTime / max(tTime, 1e-9)));
+
+			double tBest = HUGE_VAL;
+			for (uint32_t i = 0; i < m_Config.Repeat; ++i)
+			{
+				fcyStopWatch tWatch;
+				Func(tIterations);
+				tBest = min(tBest, tWatch.GetElapsed() * 1e9 / double(tIterations));
+			}
+
+			m_Results.push_back(BenchResult { Name, tBest, tIterations, BytesPerOp });
+			if (BytesPerOp > 0.)
+				printf("%-44s %12.2f ns/op %10.1f MB/s\n", Name.c_str(), tBest, BytesPerOp * 1e3 / tBest);
+			else
+				printf("%-44s %12.2f ns/op\n", Name.c_str(), tBest);
+			fflush(stdout);
+		}
+	public:
+		BenchRunner(const BenchConfig& Config)
+			: m_Config(Config) {}
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	// 测试数据
+	////////////////////////////////////////////////////////////////////////////////
+
+	const char* const s_Dirs[] =
+	{
+		"image", "Image", "audio", "se", "bgm", "boss", "stage", "bullet", "player", "enemy",
+		"effect", "ui", "font", "shader", "data", "script", "THlib", "background", "item", "laser"
+	};
+	const char* const s_Exts[] = { "png", "PNG", "jpg", "ogg", "wav", "lua", "fx", "ttf", "json", "txt" };
+	const char* const s_Seps[] = { "/", "\\", "/", "/", "|", "//" };
+
+	/// @brief 生成路径语料，包含混合分隔符、大小写、"./"与"../"
+	vector<string> MakePathCorpus(size_t Count)
+	{
+		fcyRandomWELL512 tRand(12345);
+		vector<string> tRet;
+		tRet.reserve(Count);
+		for (size_t i = 0; i < Count; ++i)
+		{
+			string tPath;
+			uint32_t tDepth = 1 + tRand.GetRandUInt(4);
+			for (uint32_t d = 0; d < tDepth; ++d)
+			{
+				uint32_t r = tRand.GetRandUInt(99);
+				if (r < 3)
+					tPath += ".";
+				else if (r < 5 && d > 0)
+					tPath += "..";
+				else
+					tPath += s_Dirs[tRand.GetRandUInt(19)];
+				tPath += s_Seps[tRand.GetRandUInt(5)];
+			}
+			tPath += s_Dirs[tRand.GetRandUInt(19)];
+			tPath += '_';
+			tPath += to_string(i);
+			tPath += '.';
+			tPath += s_Exts[tRand.GetRandUInt(9)];
+			tRet.push_back(move(tPath));
+		}
+		return tRet;
+	}
+
+	/// @brief 生成逗号分隔表，每行5个字段，混有CRLF与字段两侧空白
+	string MakeTableText(size_t Rows)
+	{
+		const vector<string> tCorpus = MakePathCorpus(1024);
+		string tText;
+		tText.reserve(Rows * 72);
+		for (size_t i = 0; i < Rows; ++i)
+		{
+			tText += to_string(i);
+			tText += ", ";
+			tText += tCorpus[i % tCorpus.size()];
+			tText += " ,";
+			tText += to_string(i * 2654435761u % 100000);
+			tText += ",0.5, enemy_";
+			tText += to_string(i & 63);
+			tText += (i & 7) ? "\n" : "\r\n";
+		}
+		return tText;
+	}
+
+	/// @brief 生成类似Lua脚本与数据表的文本
+	string MakeScriptText(size_t Lines)
+	{
+		fcyRandomWELL512 tRand(54321);
+		string tRet;
+		for (size_t i = 0; i < Lines; ++i)
+		{
+			uint32_t tIndent = tRand.GetRandUInt(3);
+			tRet.append(tIndent * 4, ' ');
+			switch (tRand.GetRandUInt(5))
+			{
+			case 0:
+				tRet += "-- 第" + to_string(i) + "波弹幕 pattern comment";
+				break;
+			case 1:
+				tRet += "local v" + to_string(i) + " = " + to_string(tRand.GetRandFloat(-100.f, 100.f));
+				break;
+			case 2:
+				tRet += "{ x = " + to_string(tRand.GetRandUInt(640)) + ", y = " + to_string(tRand.GetRandUInt(480))
+					+ ", name = \"bullet_" + to_string(tRand.GetRandUInt(32)) + "\" },";
+				break;
+			case 3:
+				tRet += to_string(tRand.GetRandUInt(1000)) + " ,\t" + to_string(tRand.GetRandFloat()) + " , boss_"
+					+ to_string(tRand.GetRandUInt(9)) + " ,  \t  image/boss/" + to_string(i) + ".png";
+				break;
+			case 4:
+				tRet += "Task.New(self, function() Task.Wait(" + to_string(tRand.GetRandUInt(120)) + ") end)";
+				break;
+			default:
+				break;
+			}
+			if (tRand.GetRandUInt(9) == 0)
+				tRet += "   \t";
+			tRet += '\n';
+		}
+		return tRet;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// 基准项目
+	////////////////////////////////////////////////////////////////////////////////
+
+	void BenchMemPool(BenchRunner& Runner)
+	{
+		// 随机的分配/释放交替序列
+		const size_t tSlots = 4096;
+		vector<uint32_t> tPattern(1 << 16);
+		fcyRandomWELL512 tRand(1);
+		for (auto& i : tPattern)
+			i = tRand.GetRandUInt(tSlots - 1);
+
+		Runner.Run("mempool/fcyMemPool<32>/churn", 0., [&](uint64_t n) {
+			fcyMemPool<32> tPool(32 * 1024);
+			vector<void*> tPtr(tSlots, nullptr);
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				void*& p = tPtr[tPattern[i & (tPattern.size() - 1)]];
+				if (p)
+				{
+					tPool.Free(p);
+					p = nullptr;
+				}
+				else
+					p = tPool.Alloc();
+			}
+			for (auto p : tPtr)
+			{
+				if (p)
+					tPool.Free(p);
+			}
+			Consume(tPool.GetFreeSize());
+		});
+
+		Runner.Run("mempool/malloc_32/churn", 0., [&](uint64_t n) {
+			vector<void*> tPtr(tSlots, nullptr);
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				void*& p = tPtr[tPattern[i & (tPattern.size() - 1)]];
+				if (p)
+				{
+					free(p);
+					p = nullptr;
+				}
+				else
+					p = malloc(32);
+			}
+			for (auto p : tPtr)
+				free(p);
+		});
+	}
+
+	void BenchRandom(BenchRunner& Runner)
+	{
+		Runner.Run("random/WELL512/GetRandUInt", 4., [](uint64_t n) {
+			fcyRandomWELL512 tRand(7);
+			uint64_t tSum = 0;
+			for (uint64_t i = 0; i < n; ++i)
+				tSum += tRand.GetRandUInt();
+			Consume(tSum);
+		});
+
+		Runner.Run("random/WELL512/GetRandFloat", 0., [](uint64_t n) {
+			fcyRandomWELL512 tRand(7);
+			float tSum = 0.f;
+			for (uint64_t i = 0; i < n; ++i)
+				tSum += tRand.GetRandFloat(-1.f, 1.f);
+			Consume((uint64_t)tSum);
+		});
+	}
+
+	void BenchHash(BenchRunner& Runner)
+	{
+		const size_t tSizes[] = { 8, 16, 64, 256, 4096, 65536 };
+		vector<uint8_t> tData(65536 + 64);
+		fcyRandomWELL512 tRand(3);
+		for (auto& i : tData)
+			i = (uint8_t)tRand.GetRandUInt();
+
+		for (size_t tSize : tSizes)
+		{
+			Runner.Run("hash/SuperFastHash/" + to_string(tSize), double(tSize), [&, tSize](uint64_t n) {
+				uint64_t tSum = 0;
+				for (uint64_t i = 0; i < n; ++i)
+					tSum += fcyHash::SuperFastHash(tData.data() + (i & 31), (uint32_t)tSize);
+				Consume(tSum);
+			});
+		}
+
+		string tText((const char*)tData.data(), 256);
+		for (size_t tSize : { (size_t)16, (size_t)256 })
+		{
+			Runner.Run("hash/HashNoCase/" + to_string(tSize), double(tSize), [&, tSize](uint64_t n) {
+				string_view tView(tText.data(), tSize);
+				uint64_t tSum = 0;
+				for (uint64_t i = 0; i < n; ++i)
+					tSum += fcyStringHelper::HashNoCase(tView);
+				Consume(tSum);
+			});
+		}
+	}
+
+	void BenchString(BenchRunner& Runner, const BenchConfig& Config)
+	{
+		const string tScript = MakeScriptText(Config.Quick ? 500 : 4000);
+		const double tScriptBytes = double(tScript.size());
+
+		vector<string> tLines;
+		fcyStringHelper::StringSplit(tScript, "\n", true, tLines);
+
+		Runner.Run("string/StringSplit/lines", tScriptBytes, [&](uint64_t n) {
+			vector<string> tOut;
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyStringHelper::StringSplit(tScript, "\n", true, tOut));
+		});
+
+		Runner.Run("string/StringSplit/fields", 0., [&](uint64_t n) {
+			vector<string> tOut;
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyStringHelper::StringSplit(tLines[i % tLines.size()], ",", false, tOut));
+		});
+
+		Runner.Run("string/Trim", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyStringHelper::Trim(tLines[i % tLines.size()]).size());
+		});
+
+		Runner.Run("string/TrimView", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyStringHelper::TrimView(tLines[i % tLines.size()]).size());
+		});
+
+		Runner.Run("string/ToLower/script", tScriptBytes, [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyStringHelper::ToLower(tScript).size());
+		});
+
+		Runner.Run("string/ToLowerInPlace/script", tScriptBytes, [&](uint64_t n) {
+			string tCopy = tScript;
+			for (uint64_t i = 0; i < n; ++i)
+				fcyStringHelper::ToLowerInPlace(tCopy);
+			Consume(tCopy.size());
+		});
+
+		Runner.Run("string/CompareNoCase/line", 0., [&](uint64_t n) {
+			uint64_t tSum = 0;
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				const string& tLine = tLines[i % tLines.size()];
+				tSum += fcyStringHelper::EqualsNoCase(tLine, tLine);
+			}
+			Consume(tSum);
+		});
+
+		Runner.Run("string/UTF8Length/script", tScriptBytes, [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyStringHelper::UTF8Length(tScript));
+		});
+
+		Runner.Run("string/MultiByteToWideChar_UTF8/line", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyStringHelper::MultiByteToWideChar_UTF8(tLines[i % tLines.size()]).size());
+		});
+
+		fcyStringConvCache tConvCache;
+		Runner.Run("string/fcyStringConvCache/line_hit", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(tConvCache.MultiByteToWideChar_UTF8(tLines[i % tLines.size()])->size());
+		});
+
+		// 预算远小于工作集，测量持续淘汰时的开销
+		fcyStringConvCache tSmallCache(16 * 1024);
+		Runner.Run("string/fcyStringConvCache/line_evict", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(tSmallCache.MultiByteToWideChar_UTF8(tLines[i % tLines.size()])->size());
+		});
+	}
+
+	void BenchPath(BenchRunner& Runner, const BenchConfig& Config)
+	{
+		const vector<string> tCorpus = MakePathCorpus(Config.Quick ? 10000 : 100000);
+		const size_t tCount = tCorpus.size();
+
+		Runner.Run("path/GetFileName", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyPathParser::GetFileName(tCorpus[i % tCount]).size());
+		});
+
+		Runner.Run("path/GetExtensionLower", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyPathParser::GetExtensionLower(tCorpus[i % tCount]).size());
+		});
+
+		Runner.Run("path/GetPath", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyPathParser::GetPath(tCorpus[i % tCount]).size());
+		});
+
+		Runner.Run("path/PathView/all", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				fcyPathParser::PathView tView(tCorpus[i % tCount]);
+				Consume(tView.GetDirectory().size() + tView.GetFileName().size() + tView.GetStem().size() + tView.GetExtension().size());
+			}
+		});
+
+		Runner.Run("path/Normalize", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(fcyPathParser::Normalize(tCorpus[i % tCount]).size());
+		});
+
+		fcyPathCache tCache;
+		for (auto& i : tCorpus)
+			tCache.GetID(i);
+		Runner.Run("path/fcyPathCache/GetID_hit", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(tCache.GetID(tCorpus[i % tCount]));
+		});
+
+		Runner.Run("path/fcyPathIndex/Build_corpus", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				fcyPathIndex tIndex;
+				for (size_t j = 0; j < tCount; ++j)
+					tIndex.Add(tCorpus[j], (uint32_t)j);
+				tIndex.Build();
+				Consume(tIndex.GetImageSize());
+			}
+		});
+
+		fcyPathIndex tIndex;
+		for (size_t j = 0; j < tCount; ++j)
+			tIndex.Add(tCorpus[j], (uint32_t)j);
+		tIndex.Build();
+
+		Runner.Run("path/fcyPathIndex/FindValue", 0., [&](uint64_t n) {
+			uint32_t tValue = 0;
+			for (uint64_t i = 0; i < n; ++i)
+				Consume(tIndex.FindValue(tCorpus[i % tCount], tValue) ? tValue : 0);
+		});
+
+		Runner.Run("path/fcyPathIndex/QueryExtension_png", 0., [&](uint64_t n) {
+			vector<uint32_t> tOut;
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				tOut.clear();
+				tIndex.QueryExtension("image", "png", true, tOut);
+				Consume(tOut.size());
+			}
+		});
+	}
+
+	void BenchTable(BenchRunner& Runner, const BenchConfig& Config)
+	{
+		// 约8MB（quick为1MB）
+		const string tText = MakeTableText(Config.Quick ? 16000 : 128000);
+		const double tBytes = (double)tText.size();
+
+		Runner.Run("table/StringSplit_lines", tBytes, [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				vector<string> tLines, tFields;
+				size_t tCount = 0;
+				fcyStringHelper::StringSplit(tText, "\n", true, tLines);
+				for (auto& l : tLines)
+				{
+					fcyStringHelper::StringSplit(l, ",", false, tFields);
+					for (auto& f : tFields)
+						tCount += fcyStringHelper::Trim(f).size();
+				}
+				Consume(tCount);
+			}
+		});
+
+		fcyTextTable::Options tSingle;
+		tSingle.ThreadCount = 1;
+		Runner.Run("table/fcyTextTable/Parse_1thread", tBytes, [&](uint64_t n) {
+			fcyTextTable tTable;
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				tTable.Parse(tText, tSingle);
+				Consume(tTable.GetTotalFieldCount());
+			}
+		});
+
+		fcyTextTable::Options tParallel;
+		tParallel.MinChunkSize = 64 * 1024;
+		Runner.Run("table/fcyTextTable/Parse_parallel", tBytes, [&](uint64_t n) {
+			fcyTextTable tTable;
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				tTable.Parse(tText, tParallel);
+				Consume(tTable.GetTotalFieldCount());
+			}
+		});
+	}
+
+	void BenchMisc(BenchRunner& Runner)
+	{
+		Runner.Run("stopwatch/GetElapsed", 0., [](uint64_t n) {
+			fcyStopWatch tWatch;
+			double tSum = 0.;
+			for (uint64_t i = 0; i < n; ++i)
+				tSum += tWatch.GetElapsed();
+			Consume((uint64_t)tSum);
+		});
+
+		Runner.Run("stopwatch/GetElapsedTicks", 0., [](uint64_t n) {
+			fcyStopWatch tWatch;
+			uint64_t tSum = 0;
+			for (uint64_t i = 0; i < n; ++i)
+				tSum += tWatch.GetElapsedTicks();
+			Consume(tSum);
+		});
+
+		fcyHdrHistogram tHist;
+		Runner.Run("histogram/Record", 0., [&](uint64_t n) {
+			for (uint64_t i = 0; i < n; ++i)
+				tHist.Record(16000000 + (i * 2654435761u & 0xFFFFF));
+			Consume(tHist.GetTotalCount());
+		});
+
+		Runner.Run("profiler/zone", 0., [](uint64_t n) {
+			fcyProfiler& tProfiler = fcyProfiler::GetInstance();
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				fcyProfileZone tZone("bench");
+				if ((i & 1023) == 1023)
+					tProfiler.EndFrame();
+			}
+			tProfiler.EndFrame();
+		});
+
+		fcyPerfCounterGroup tCounters;
+		Runner.Run(string("perfcounter/GetElapsed/") + (tCounters.IsAvailable() ? (tCounters.GetMode() == fcyPerfCounterGroup::Mode_Hardware ? "hw" : "sw") : "none"), 0., [&](uint64_t n) {
+			fcyPerfCounterGroup::Values tValues;
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				tCounters.GetElapsed(tValues);
+				Consume(tValues.Value[0]);
+			}
+		});
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	// 结果输出与比较
+	////////////////////////////////////////////////////////////////////////////////
+
+	void WriteJson(ostream& Out, const vector<BenchResult>& Results, const BenchConfig& Config)
+	{
+		Out << "{\n  \"version\": 1,\n";
+		Out << "  \"quick\": " << (Config.Quick ? "true" : "false") << ",\n";
+		Out << "  \"tsc\": " << (fcyStopWatch::IsTSCEnabled() ? "true" : "false") << ",\n";
+		Out << "  \"benchmarks\": [";
+		char tBuf[64];
+		for (size_t i = 0; i < Results.size(); ++i)
+		{
+			const BenchResult& r = Results[i];
+			Out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.Name << "\"";
+			snprintf(tBuf, sizeof(tBuf), "%.4f", r.NsPerOp);
+			Out << ", \"ns_per_op\": " << tBuf << ", \"iterations\": " << r.Iterations;
+			if (r.BytesPerOp > 0.)
+			{
+				snprintf(tBuf, sizeof(tBuf), "%.2f", r.BytesPerOp * 1e3 / r.NsPerOp);
+				Out << ", \"mb_per_s\": " << tBuf;
+			}
+			Out << "}";
+		}
+		Out << "\n  ]\n}\n";
+	}
+
+	/// @brief 从本程序输出的JSON中读取name与ns_per_op
+	bool ReadBaseline(const string& Path, map<string, double>& Out)
+	{
+		ifstream tFile(Path, ios::binary);
+		if (!tFile)
+			return false;
+		stringstream tStream;
+		tStream << tFile.rdbuf();
+		const string tText = tStream.str();
+
+		size_t tPos = 0;
+		for (;;)
+		{
+			size_t tName = tText.find("\"name\"", tPos);
+			if (tName == string::npos)
+				break;
+			size_t tBegin = tText.find('"', tText.find(':', tName) + 1);
+			size_t tEnd = tText.find('"', tBegin + 1);
+			size_t tValue = tText.find("\"ns_per_op\"", tEnd);
+			if (tBegin == string::npos || tEnd == string::npos || tValue == string::npos)
+				break;
+			Out[tText.substr(tBegin + 1, tEnd - tBegin - 1)] = strtod(tText.c_str() + tText.find(':', tValue) + 1, nullptr);
+			tPos = tValue;
+		}
+		return !Out.empty();
+	}
+
+	/// @brief 与基准比较，返回变慢超过阈值的项目数
+	uint32_t CompareBaseline(const vector<BenchResult>& Results, const map<string, double>& Baseline, double Threshold)
+	{
+		uint32_t tRegressions = 0;
+		printf("\n%-44s %12s %12s %9s\n", "benchmark", "baseline", "current", "change");
+		for (auto& r : Results)
+		{
+			auto i = Baseline.find(r.Name);
+			if (i == Baseline.end() || i->second <= 0.)
+			{
+				printf("%-44s %12s %12.2f %9s\n", r.Name.c_str(), "-", r.NsPerOp, "new");
+				continue;
+			}
+			double tChange = r.NsPerOp / i->second - 1.;
+			bool tRegressed = tChange > Threshold;
+			if (tRegressed)
+				++tRegressions;
+			printf("%-44s %12.2f %12.2f %+8.1f%%%s\n", r.Name.c_str(), i->second, r.NsPerOp, tChange * 100.,
+				tRegressed ? "  REGRESSION" : (tChange < -Threshold ? "  improved" : ""));
+		}
+		return tRegressions;
+	}
+
+	void PrintUsage()
+	{
+		printf(
+			"usage: fcyBenchmark [options]\n"
+			"  --quick             short runs, smaller corpora (for smoke tests)\n"
+			"  --filter <substr>   only run benchmarks whose name contains substr\n"
+			"  --out <file>        write results as JSON\n"
+			"  --baseline <file>   compare with a previous JSON result\n"
+			"  --threshold <r>     regression threshold as a ratio (default 0.1)\n"
+			"  --repeat <n>        runs per benchmark, fastest is kept (default 5)\n"
+			"  --min-time <s>      minimum time per run in seconds (default 0.2)\n");
+	}
+
+	bool ParseArgs(int argc, char* argv[], BenchConfig& Config)
+	{
+		bool tRepeatSet = false, tMinTimeSet = false;
+		for (int i = 1; i < argc; ++i)
+		{
+			string tArg = argv[i];
+			bool tHasValue = i + 1 < argc;
+			if (tArg == "--quick")
+				Config.Quick = true;
+			else if (tArg == "--filter" && tHasValue)
+				Config.Filter = argv[++i];
+			else if (tArg == "--out" && tHasValue)
+				Config.OutPath = argv[++i];
+			else if (tArg == "--baseline" && tHasValue)
+				Config.BaselinePath = argv[++i];
+			else if (tArg == "--threshold" && tHasValue)
+				Config.Threshold = atof(argv[++i]);
+			else if (tArg == "--repeat" && tHasValue)
+			{
+				Config.Repeat = max(1, atoi(argv[++i]));
+				tRepeatSet = true;
+			}
+			else if (tArg == "--min-time" && tHasValue)
+			{
+				Config.MinTime = max(1e-4, atof(argv[++i]));
+				tMinTimeSet = true;
+			}
+			else
+				return false;
+		}
+
+		if (Config.Quick)
+		{
+			if (!tRepeatSet)
+				Config.Repeat = 1;
+			if (!tMinTimeSet)
+				Config.MinTime = 0.002;
+		}
+		return true;
+	}
+	////////////////////////////////////////////////////////////////////////////////
+	// 结果校验
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief 校验失败计数
+	uint32_t g_VerifyFailures = 0;
+
+	void Check(bool Condition, const char* What)
+	{
+		if (!Condition)
+		{
+			fprintf(stderr, "verify failed: %s\n", What);
+			++g_VerifyFailures;
+		}
+	}
+
+	/// @brief  在计时前校验被测函数的结果
+	/// @return 全部通过时返回true
+	bool VerifyResults()
+	{
+		g_VerifyFailures = 0;
+
+		// 字符串
+		{
+			vector<string> tSplit;
+			vector<string_view> tSplitView;
+			const string tLine = " a, b ,,c ";
+			fcyStringHelper::StringSplit(tLine, ",", false, tSplit);
+			fcyStringHelper::StringSplitView(tLine, ",", false, tSplitView);
+			bool tSame = tSplit.size() == 4 && tSplitView.size() == 4;
+			for (size_t i = 0; tSame && i < tSplit.size(); ++i)
+				tSame = tSplit[i] == tSplitView[i];
+			Check(tSame, "StringSplitView matches StringSplit");
+			Check(fcyStringHelper::TrimView(" \t x y \r\n") == "x y", "TrimView");
+			Check(fcyStringHelper::ToLower("Image/BOSS.PNG") == "image/boss.png", "ToLower");
+			Check(fcyStringHelper::UTF8Length("第1波") == 3, "UTF8Length");
+
+			const string tText = "弾幕 text \xC3\xA9";
+			fcyStringConvCache tCache;
+			fcyStringConvCache::WStringPtr a = tCache.MultiByteToWideChar_UTF8(tText);
+			fcyStringConvCache::WStringPtr b = tCache.MultiByteToWideChar_UTF8(tText);
+			Check(*a == fcyStringHelper::MultiByteToWideChar_UTF8(tText), "fcyStringConvCache result");
+			Check(a == b && tCache.GetStats().Hits == 1 && tCache.GetStats().Misses == 1, "fcyStringConvCache hit");
+		}
+
+		// 路径
+		{
+			Check(fcyPathParser::Normalize("Image/./Boss/../A.PNG") == "image\\a.png", "Normalize dot segments");
+			Check(fcyPathParser::Normalize("a//b|c") == "a\\b\\c", "Normalize separators");
+			Check(fcyPathParser::Normalize("a/../../x") == "..\\x", "Normalize leading ..");
+			Check(fcyPathParser::GetFileName("image/boss\\a.png") == "a.png", "GetFileName");
+
+			const vector<string> tCorpus = MakePathCorpus(5000);
+			map<string, uint32_t> tNormalized;
+			for (auto& i : tCorpus)
+				++tNormalized[fcyPathParser::Normalize(i)];
+
+			fcyPathCache tCache;
+			fcyPathIndex tIndex;
+			for (size_t j = 0; j < tCorpus.size(); ++j)
+			{
+				tCache.GetID(tCorpus[j]);
+				tIndex.Add(tCorpus[j], (uint32_t)j);
+			}
+			tIndex.Build();
+			Check(tCache.GetCanonicalCount() == tNormalized.size(), "fcyPathCache canonical count");
+
+			bool tFound = true;
+			for (size_t j = 0; j < tCorpus.size() && tFound; ++j)
+			{
+				uint32_t tValue = 0;
+				if (tNormalized[fcyPathParser::Normalize(tCorpus[j])] == 1)
+					tFound = tIndex.FindValue(tCorpus[j], tValue) && tValue == j;
+			}
+			Check(tFound, "fcyPathIndex FindValue");
+
+			size_t tPngCount = 0;
+			for (auto& i : tNormalized)
+			{
+				if (i.first.compare(0, 6, "image\\") == 0 && i.first.size() > 4 && i.first.compare(i.first.size() - 4, 4, ".png") == 0)
+					++tPngCount;
+			}
+			vector<uint32_t> tOut;
+			tIndex.QueryExtension("image", "png", true, tOut);
+			Check(tOut.size() == tPngCount, "fcyPathIndex QueryExtension");
+		}
+
+		// 直方图
+		{
+			fcyHdrHistogram tHist;
+			uint64_t tMax = 0;
+			for (uint64_t i = 1; i <= 10000; ++i)
+			{
+				uint64_t v = 1000 + (i * 2654435761u & 0xFFFFF);
+				tHist.Record(v);
+				tMax = max(tMax, v);
+			}
+			Check(tHist.GetTotalCount() == 10000, "histogram count");
+			Check(tHist.GetValueAtPercentile(100.) == tMax && tHist.GetMax() == tMax, "histogram p100");
+			uint64_t tMedian = tHist.GetValueAtPercentile(50.);
+			Check(tMedian > 1000 + 0x80000 - 0x4000 && tMedian < 1000 + 0x80000 + 0x4000, "histogram p50");
+
+			vector<uint8_t> tData;
+			tHist.Serialize(tData);
+			fcyHdrHistogram tLoaded;
+			Check(tLoaded.Deserialize(tData.data(), tData.size()) && tLoaded.GetMean() == tHist.GetMean()
+				&& tLoaded.GetValueAtPercentile(99.) == tHist.GetValueAtPercentile(99.), "histogram round trip");
+		}
+
+		// 文本表
+		{
+			const size_t tRows = 20000;
+			const string tText = MakeTableText(tRows);
+			fcyTextTable::Options tSingle;
+			tSingle.ThreadCount = 1;
+			fcyTextTable::Options tParallel;
+			tParallel.ThreadCount = 4;
+			tParallel.MinChunkSize = 4096;
+
+			fcyTextTable a, b;
+			a.Parse(tText, tSingle);
+			b.Parse(tText, tParallel);
+			Check(a.GetRecordCount() == tRows && a.GetTotalFieldCount() == tRows * 5, "fcyTextTable field count");
+			Check(b.GetRecordCount() == tRows && b.GetTotalFieldCount() == tRows * 5, "fcyTextTable parallel field count");
+
+			bool tSame = true;
+			for (size_t r = 0; r < tRows && tSame; ++r)
+			{
+				tSame = a.GetLineNumber(r) == r + 1 && b.GetLineNumber(r) == r + 1
+					&& a.GetField(r, 0) == to_string(r) && a.GetField(r, 4) == "enemy_" + to_string(r & 63);
+				for (uint32_t f = 0; f < 5 && tSame; ++f)
+					tSame = a.GetField(r, f) == b.GetField(r, f);
+			}
+			Check(tSame, "fcyTextTable fields");
+		}
+
+		return g_VerifyFailures == 0;
+	}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	BenchConfig tConfig;
+	if (!ParseArgs(argc, argv, tConfig))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	printf("fcylib benchmark (%s timer, %llu ticks/s)\n\n",
+		fcyStopWatch::IsTSCEnabled() ? "TSC" : "platform", (unsigned long long)fcyStopWatch::GetFrequency());
+
+	if (!VerifyResults())
+	{
+		fprintf(stderr, "%u result check(s) failed\n", g_VerifyFailures);
+		return 1;
+	}
+
+	BenchRunner tRunner(tConfig);
+	BenchMemPool(tRunner);
+	BenchRandom(tRunner);
+	BenchHash(tRunner);
+	BenchString(tRunner, tConfig);
+	BenchPath(tRunner, tConfig);
+	BenchTable(tRunner, tConfig);
+	BenchMisc(tRunner);
+
+	const vector<BenchResult>& tResults = tRunner.GetResults();
+	for (auto& r : tResults)
+	{
+		if (!(r.NsPerOp > 0.) || !isfinite(r.NsPerOp))
+		{
+			fprintf(stderr, "invalid result for %s\n", r.Name.c_str());
+			return 1;
+		}
+	}
+
+	if (!tConfig.OutPath.empty())
+	{
+		ofstream tFile(tConfig.OutPath, ios::binary);
+		if (!tFile)
+		{
+			fprintf(stderr, "cannot write %s\n", tConfig.OutPath.c_str());
+			return 1;
+		}
+		WriteJson(tFile, tResults, tConfig);
+	}
+
+	if (!tConfig.BaselinePath.empty())
+	{
+		map<string, double> tBaseline;
+		if (!ReadBaseline(tConfig.BaselinePath, tBaseline))
+		{
+			fprintf(stderr, "cannot read baseline %s\n", tConfig.BaselinePath.c_str());
+			return 1;
+		}
+		uint32_t tRegressions = CompareBaseline(tResults, tBaseline, tConfig.Threshold);
+		if (tRegressions > 0)
+		{
+			printf("\n%u regression(s) above %.1f%%\n", tRegressions, tConfig.Threshold * 100.);
+			return 1;
+		}
+		printf("\nno regressions above %.1f%%\n", tConfig.Threshold * 100.);
+	}
+	return 0;
+}
@@ -6,6 +6,8 @@
 //#include "../fcyType.h"
 //#include "fcyDebug.h"
 
+#include <cstdint>
+#include <cstdlib>
 #include <vector>
 
 /// @addtogroup fancy库底层支持
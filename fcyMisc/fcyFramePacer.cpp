@@ -0,0 +1,163 @@
+﻿#include "fcyFramePacer.h"
+#include "fcyStopWatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+// 睡眠超时统计的平滑系数
+static const double OversleepAlpha = 1. / 16.;
+
+fcyFramePacer::fcyFramePacer(double FPS)
+	: m_MaxCatchUpSteps(4)
+{
+	SetTargetFPS(FPS);
+	Reset();
+}
+
+fcyFramePacer::~fcyFramePacer()
+{
+}
+
+void fcyFramePacer::SetTargetFPS(double FPS)
+{
+	if (!(FPS > 0.))
+		FPS = 60.;
+	m_Period = max<uint64_t>((uint64_t)(double(fcyStopWatch::GetFrequency()) / FPS), 1);
+}
+
+double fcyFramePacer::GetTargetFPS()const
+{
+	return double(fcyStopWatch::GetFrequency()) / double(m_Period);
+}
+
+void fcyFramePacer::SetMaxCatchUpSteps(uint32_t MaxSteps)
+{
+	m_MaxCatchUpSteps = max(MaxSteps, 1u);
+}
+
+void fcyFramePacer::Reset()
+{
+	const double tFreq = double(fcyStopWatch::GetFrequency());
+
+	// 初始余量为常见的1ms睡眠超时
+	m_MinMargin = tFreq * 50e-6;
+	m_Margin = tFreq * 1e-3;
+	m_OversleepMean = m_Margin;
+	m_OversleepVar = 0.;
+
+	m_FrameCount = 0;
+	m_MissedCount = 0;
+	m_DroppedSteps = 0;
+
+	m_LastFrame = fcyStopWatch::GetTimestamp();
+	m_LastDelta = m_Period;
+	m_NextDeadline = m_LastFrame + m_Period;
+}
+
+void fcyFramePacer::applyMargin()
+{
+	// 余量不超过半个周期，保证帧内工作结束后仍有机会睡眠并重新采样
+	double tMargin = m_OversleepMean + 3. * sqrt(m_OversleepVar);
+	m_Margin = min(max(tMargin, m_MinMargin), double(m_Period) / 2.);
+}
+
+void fcyFramePacer::updateMargin(double Oversleep)
+{
+	double tDiff = Oversleep - m_OversleepMean;
+	m_OversleepMean += OversleepAlpha * tDiff;
+	m_OversleepVar = (1. - OversleepAlpha) * (m_OversleepVar + OversleepAlpha * tDiff * tDiff);
+	applyMargin();
+}
+
+void fcyFramePacer::decayMargin()
+{
+	// 没有睡眠就没有新样本，让统计逐渐回落，以免一次突发的超时使余量永久偏大
+	m_OversleepMean -= OversleepAlpha * (m_OversleepMean - m_MinMargin);
+	m_OversleepVar *= 1. - OversleepAlpha;
+	applyMargin();
+}
+
+void fcyFramePacer::sleepUntil(uint64_t Deadline)
+{
+	const double tFreq = double(fcyStopWatch::GetFrequency());
+
+	uint64_t tNow = fcyStopWatch::GetTimestamp();
+	bool tSlept = false;
+	while (tNow < Deadline && double(Deadline - tNow) > m_Margin)
+	{
+		double tRequest = double(Deadline - tNow) - m_Margin;
+		this_thread::sleep_for(chrono::duration<double>(tRequest / tFreq));
+
+		uint64_t tAfter = fcyStopWatch::GetTimestamp();
+		updateMargin(double(tAfter - tNow) - tRequest);
+		tNow = tAfter;
+		tSlept = true;
+	}
+
+	if (!tSlept && tNow < Deadline)
+		decayMargin();
+
+	// 最后一段自旋，让出时间片以免独占核心
+	while (tNow < Deadline)
+	{
+		this_thread::yield();
+		tNow = fcyStopWatch::GetTimestamp();
+	}
+}
+
+uint32_t fcyFramePacer::WaitForNextFrame()
+{
+	uint32_t tSteps = 1;
+
+	uint64_t tNow = fcyStopWatch::GetTimestamp();
+	if (tNow <= m_NextDeadline)
+	{
+		sleepUntil(m_NextDeadline);
+		m_NextDeadline += m_Period;
+	}
+	else
+	{
+		++m_MissedCount;
+
+		uint64_t tLate = (tNow - m_NextDeadline) / m_Period;
+		if (tLate + 1 > m_MaxCatchUpSteps)
+		{
+			// 落后过多，丢弃多余的步数并以当前时间重新对齐
+			m_DroppedSteps += tLate + 1 - m_MaxCatchUpSteps;
+			tSteps = m_MaxCatchUpSteps;
+			m_NextDeadline = tNow + m_Period;
+		}
+		else
+		{
+			tSteps = (uint32_t)tLate + 1;
+			m_NextDeadline += (tLate + 1) * m_Period;
+		}
+	}
+
+	tNow = fcyStopWatch::GetTimestamp();
+	m_LastDelta = tNow - m_LastFrame;
+	m_LastFrame = tNow;
+	++m_FrameCount;
+	return tSteps;
+}
+
+double fcyFramePacer::GetFrameDelta()const
+{
+	return fcyStopWatch::TicksToSeconds(m_LastDelta);
+}
+
+double fcyFramePacer::GetFixedDelta()const
+{
+	return fcyStopWatch::TicksToSeconds(m_Period);
+}
+
+double fcyFramePacer::GetSleepMargin()const
+{
+	return m_Margin / double(fcyStopWatch::GetFrequency());
+}
@@ -0,0 +1,83 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyFramePacer.h
+/// @brief fancy帧率控制
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+
+/// @addtogroup fancy杂项
+/// @{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 睡眠与自旋混合的帧率控制器
+/// @note  以fcyStopWatch的时间戳维护固定周期的帧截止时间。等待时先睡眠到截止时间前的余量处，
+///        再自旋到截止时间；余量根据观测到的睡眠超时（均值+3倍标准差）自适应调整，不超过半个周期，
+///        未发生睡眠的帧中余量逐渐回落。
+///        错过截止时间时返回需要追赶的固定步数，超过上限的步数被丢弃并重新对齐截止时间。
+///        Windows下睡眠精度取决于系统计时器分辨率（timeBeginPeriod）。
+////////////////////////////////////////////////////////////////////////////////
+class fcyFramePacer
+{
+private:
+	uint64_t m_Period;           ///< @brief 帧周期（计时周期）
+	uint64_t m_NextDeadline;     ///< @brief 下一帧截止时间
+	uint64_t m_LastFrame;        ///< @brief 上一帧开始时间
+	uint64_t m_LastDelta;        ///< @brief 上一帧间隔
+	uint32_t m_MaxCatchUpSteps;  ///< @brief 单帧最多追赶的步数
+	double m_Margin;             ///< @brief 睡眠余量（计时周期）
+	double m_MinMargin;          ///< @brief 最小余量
+	double m_OversleepMean;      ///< @brief 睡眠超时的指数滑动平均
+	double m_OversleepVar;       ///< @brief 睡眠超时的指数滑动方差
+	uint64_t m_FrameCount;       ///< @brief 帧数
+	uint64_t m_MissedCount;      ///< @brief 错过截止时间的帧数
+	uint64_t m_DroppedSteps;     ///< @brief 因超过追赶上限而丢弃的步数
+private:
+	void sleepUntil(uint64_t Deadline);
+	void updateMargin(double Oversleep);
+	void decayMargin();
+	void applyMargin();
+public:
+	/// @brief     设置目标帧率
+	/// @note      立即生效，不重置统计
+	/// @param[in] FPS 每秒帧数
+	void SetTargetFPS(double FPS);
+
+	/// @brief 获得目标帧率
+	double GetTargetFPS()const;
+
+	/// @brief     设置单帧最多追赶的步数
+	/// @param[in] MaxSteps 最大步数，至少为1
+	void SetMaxCatchUpSteps(uint32_t MaxSteps);
+
+	/// @brief 以当前时间重新开始计时并清空统计
+	void Reset();
+
+	/// @brief  等待到下一帧的截止时间
+	/// @note   按时到达时返回1；错过截止时间时返回包括本帧在内需要执行的固定步数，不超过追赶上限
+	/// @return 本帧应执行的固定步数
+	uint32_t WaitForNextFrame();
+
+	/// @brief 获得上一帧的实际间隔，以秒为单位
+	double GetFrameDelta()const;
+
+	/// @brief 获得固定步长，以秒为单位
+	double GetFixedDelta()const;
+
+	/// @brief 获得当前的睡眠余量，以秒为单位
+	double GetSleepMargin()const;
+
+	/// @brief 获得帧数
+	uint64_t GetFrameCount()const { return m_FrameCount; }
+
+	/// @brief 获得错过截止时间的帧数
+	uint64_t GetMissedCount()const { return m_MissedCount; }
+
+	/// @brief 获得因超过追赶上限而丢弃的步数
+	uint64_t GetDroppedStepCount()const { return m_DroppedSteps; }
+public:
+	/// @brief     构造函数
+	/// @param[in] FPS 目标帧率
+	fcyFramePacer(double FPS = 60.);
+	~fcyFramePacer();
+};
+/// @}
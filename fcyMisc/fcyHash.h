@@ -3,6 +3,7 @@
 /// @brief fancy哈希
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
+#include <cstdint>
 #include <functional>
 
 /// @addtogroup fancy杂项
@@ -0,0 +1,330 @@
+﻿#include "fcyHistogram.h"
+#include "fcyStopWatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const uint32_t HistogramMagic = 0x52444846;  // 'FHDR'
+static const uint32_t HistogramVersion = 2;
+
+// 最高有效位的位置，Value不为0
+static inline uint32_t HighestBit(uint64_t Value)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long tIndex;
+	_BitScanReverse64(&tIndex, Value);
+	return (uint32_t)tIndex;
+#elif defined(__GNUC__) || defined(__clang__)
+	return 63 - (uint32_t)__builtin_clzll(Value);
+#else
+	uint32_t tRet = 0;
+	while (Value >>= 1)
+		++tRet;
+	return tRet;
+#endif
+}
+
+static void WriteVarUInt(vector<uint8_t>& Out, uint64_t Value)
+{
+	while (Value >= 0x80)
+	{
+		Out.push_back((uint8_t)(Value | 0x80));
+		Value >>= 7;
+	}
+	Out.push_back((uint8_t)Value);
+}
+
+static bool ReadVarUInt(const uint8_t*& p, const uint8_t* pEnd, uint64_t& Out)
+{
+	Out = 0;
+	for (uint32_t tShift = 0; tShift < 64; tShift += 7)
+	{
+		if (p >= pEnd)
+			return false;
+		uint8_t b = *p++;
+		Out |= (uint64_t)(b & 0x7F) << tShift;
+		if (!(b & 0x80))
+			return true;
+	}
+	return false;
+}
+
+fcyHdrHistogram::fcyHdrHistogram(uint64_t HighestTrackableValue, uint32_t SignificantDigits)
+{
+	init(HighestTrackableValue, SignificantDigits);
+}
+
+fcyHdrHistogram::~fcyHdrHistogram()
+{
+}
+
+void fcyHdrHistogram::init(uint64_t HighestTrackableValue, uint32_t SignificantDigits)
+{
+	SignificantDigits = min(max(SignificantDigits, 1u), 5u);
+	HighestTrackableValue = max<uint64_t>(HighestTrackableValue, 2);
+
+	m_HighestTrackable = HighestTrackableValue;
+	m_SignificantDigits = SignificantDigits;
+
+	// 每个桶至少细分为2*10^n份，才能保证n位有效数字
+	uint64_t tLargestSingleUnit = 2;
+	for (uint32_t i = 0; i < SignificantDigits; ++i)
+		tLargestSingleUnit *= 10;
+	uint32_t tSubBucketCountMag = HighestBit(tLargestSingleUnit - 1) + 1;
+	m_SubBucketHalfCountMag = tSubBucketCountMag - 1;
+	m_SubBucketHalfCount = 1ull << m_SubBucketHalfCountMag;
+	m_SubBucketMask = (1ull << tSubBucketCountMag) - 1;
+
+	uint64_t tSmallestUntrackable = 1ull << tSubBucketCountMag;
+	m_BucketCount = 1;
+	while (tSmallestUntrackable <= HighestTrackableValue)
+	{
+		++m_BucketCount;
+		if (tSmallestUntrackable > (UINT64_MAX >> 1))
+			break;
+		tSmallestUntrackable <<= 1;
+	}
+
+	m_Counts.assign((size_t)(m_BucketCount + 1) * (size_t)m_SubBucketHalfCount, 0);
+	Reset();
+}
+
+size_t fcyHdrHistogram::countsIndex(uint64_t Value)const
+{
+	uint32_t tBucket = HighestBit(Value | m_SubBucketMask) - m_SubBucketHalfCountMag;
+	uint64_t tSubBucket = Value >> tBucket;
+	return (size_t)((uint64_t)tBucket << m_SubBucketHalfCountMag) + (size_t)tSubBucket;
+}
+
+uint64_t fcyHdrHistogram::valueFromIndex(size_t Index)const
+{
+	int32_t tBucket = (int32_t)(Index >> m_SubBucketHalfCountMag) - 1;
+	uint64_t tSubBucket = (Index & (m_SubBucketHalfCount - 1)) + m_SubBucketHalfCount;
+	if (tBucket < 0)
+	{
+		tSubBucket -= m_SubBucketHalfCount;
+		tBucket = 0;
+	}
+	return tSubBucket << tBucket;
+}
+
+uint64_t fcyHdrHistogram::highestEquivalentValue(uint64_t Value)const
+{
+	uint32_t tBucket = HighestBit(Value | m_SubBucketMask) - m_SubBucketHalfCountMag;
+	uint64_t tLowest = (Value >> tBucket) << tBucket;
+	return tLowest + (1ull << tBucket) - 1;
+}
+
+bool fcyHdrHistogram::Record(uint64_t Value)
+{
+	return RecordValues(Value, 1);
+}
+
+bool fcyHdrHistogram::RecordValues(uint64_t Value, uint64_t Count)
+{
+	bool tRet = true;
+	if (Value > m_HighestTrackable)
+	{
+		Value = m_HighestTrackable;
+		m_SaturatedCount += Count;
+		tRet = false;
+	}
+
+	m_Counts[countsIndex(Value)] += Count;
+	m_TotalCount += Count;
+	m_Min = min(m_Min, Value);
+	m_Max = max(m_Max, Value);
+	m_Sum += double(Value) * double(Count);
+	return tRet;
+}
+
+bool fcyHdrHistogram::RecordSeconds(double Seconds)
+{
+	if (!(Seconds > 0.))
+		return Record(0);
+	double tNanoseconds = Seconds * 1e9 + 0.5;
+	if (tNanoseconds >= 18446744073709551615.)
+		return Record(UINT64_MAX);
+	return Record((uint64_t)tNanoseconds);
+}
+
+bool fcyHdrHistogram::RecordElapsed(fcyStopWatch& Watch)
+{
+	return RecordSeconds(Watch.GetElapsed());
+}
+
+void fcyHdrHistogram::Reset()
+{
+	fill(m_Counts.begin(), m_Counts.end(), 0);
+	m_TotalCount = 0;
+	m_SaturatedCount = 0;
+	m_Min = UINT64_MAX;
+	m_Max = 0;
+	m_Sum = 0.;
+}
+
+void fcyHdrHistogram::Merge(const fcyHdrHistogram& Other)
+{
+	if (Other.m_TotalCount == 0)
+		return;
+
+	if (Other.m_HighestTrackable == m_HighestTrackable && Other.m_SignificantDigits == m_SignificantDigits)
+	{
+		for (size_t i = 0; i < m_Counts.size(); ++i)
+			m_Counts[i] += Other.m_Counts[i];
+		m_TotalCount += Other.m_TotalCount;
+		m_SaturatedCount += Other.m_SaturatedCount;
+		m_Min = min(m_Min, Other.m_Min);
+		m_Max = max(m_Max, Other.m_Max);
+		m_Sum += Other.m_Sum;
+		return;
+	}
+
+	const uint64_t tMin = m_Min, tMax = m_Max;
+	const double tSum = m_Sum;
+	for (size_t i = 0; i < Other.m_Counts.size(); ++i)
+	{
+		if (Other.m_Counts[i])
+			RecordValues(Other.valueFromIndex(i), Other.m_Counts[i]);
+	}
+	// 对方范围更大时，其截断的计数已在上面重新记录时计入
+	if (Other.m_HighestTrackable <= m_HighestTrackable)
+		m_SaturatedCount += Other.m_SaturatedCount;
+
+	// 重新记录使用的是桶下界，用对方的精确值恢复最值与总和（超出本方范围的值按截断处理）
+	m_Min = min(tMin, min(Other.m_Min, m_HighestTrackable));
+	m_Max = max(tMax, min(Other.m_Max, m_HighestTrackable));
+	if (Other.m_Max <= m_HighestTrackable)
+		m_Sum = tSum + Other.m_Sum;
+}
+
+uint64_t fcyHdrHistogram::GetValueAtPercentile(double Percentile)const
+{
+	if (m_TotalCount == 0)
+		return 0;
+
+	Percentile = min(max(Percentile, 0.), 100.);
+	uint64_t tTarget = (uint64_t)ceil(Percentile / 100. * double(m_TotalCount));
+	tTarget = max<uint64_t>(tTarget, 1);
+
+	uint64_t tAccum = 0;
+	for (size_t i = 0; i < m_Counts.size(); ++i)
+	{
+		tAccum += m_Counts[i];
+		// 最后一个非空桶必含最大值，直接返回精确的最大值
+		if (tAccum == m_TotalCount)
+			return m_Max;
+		if (tAccum >= tTarget)
+			return min(highestEquivalentValue(valueFromIndex(i)), m_Max);
+	}
+	return m_Max;
+}
+
+void fcyHdrHistogram::Serialize(vector<uint8_t>& Out)const
+{
+	Out.clear();
+	WriteVarUInt(Out, HistogramMagic);
+	WriteVarUInt(Out, HistogramVersion);
+	WriteVarUInt(Out, m_HighestTrackable);
+	WriteVarUInt(Out, m_SignificantDigits);
+	WriteVarUInt(Out, m_SaturatedCount);
+	WriteVarUInt(Out, GetMin());
+	WriteVarUInt(Out, m_Max);
+
+	// 总和按IEEE 754位模式写入，保证往返后平均值不变
+	uint64_t tSumBits;
+	memcpy(&tSumBits, &m_Sum, sizeof(tSumBits));
+	WriteVarUInt(Out, tSumBits);
+
+	// 去掉末尾的零计数
+	size_t tLen = m_Counts.size();
+	while (tLen > 0 && m_Counts[tLen - 1] == 0)
+		--tLen;
+	WriteVarUInt(Out, tLen);
+
+	// 计数c写为2c+1，n个连续的零写为2n
+	for (size_t i = 0; i < tLen; )
+	{
+		if (m_Counts[i] == 0)
+		{
+			size_t tRun = 0;
+			while (i < tLen && m_Counts[i] == 0)
+			{
+				++tRun;
+				++i;
+			}
+			WriteVarUInt(Out, (uint64_t)tRun << 1);
+		}
+		else
+		{
+			WriteVarUInt(Out, (m_Counts[i] << 1) | 1);
+			++i;
+		}
+	}
+}
+
+bool fcyHdrHistogram::Deserialize(const void* pData, size_t Len)
+{
+	const uint8_t* p = (const uint8_t*)pData;
+	const uint8_t* pEnd = p + Len;
+
+	// 版本1不含总和，平均值由桶下界近似
+	uint64_t tMagic, tVersion, tHighest, tDigits, tSaturated, tMin, tMax, tSumBits = 0, tLen;
+	if (!pData
+		|| !ReadVarUInt(p, pEnd, tMagic) || tMagic != HistogramMagic
+		|| !ReadVarUInt(p, pEnd, tVersion) || tVersion < 1 || tVersion > HistogramVersion
+		|| !ReadVarUInt(p, pEnd, tHighest) || !ReadVarUInt(p, pEnd, tDigits)
+		|| !ReadVarUInt(p, pEnd, tSaturated) || !ReadVarUInt(p, pEnd, tMin)
+		|| !ReadVarUInt(p, pEnd, tMax)
+		|| (tVersion >= 2 && !ReadVarUInt(p, pEnd, tSumBits))
+		|| !ReadVarUInt(p, pEnd, tLen))
+		return false;
+	if (tDigits < 1 || tDigits > 5 || tHighest < 2)
+		return false;
+
+	fcyHdrHistogram tRet(tHighest, (uint32_t)tDigits);
+	if (tLen > tRet.m_Counts.size())
+		return false;
+
+	for (size_t i = 0; i < tLen; )
+	{
+		uint64_t tCode;
+		if (!ReadVarUInt(p, pEnd, tCode))
+			return false;
+		if (tCode & 1)
+		{
+			uint64_t tCount = tCode >> 1;
+			tRet.m_Counts[i] = tCount;
+			tRet.m_TotalCount += tCount;
+			tRet.m_Sum += double(tRet.valueFromIndex(i)) * double(tCount);
+			++i;
+		}
+		else
+		{
+			uint64_t tRun = tCode >> 1;
+			if (tRun == 0 || tRun > tLen - i)
+				return false;
+			i += (size_t)tRun;
+		}
+	}
+
+	tRet.m_SaturatedCount = tSaturated;
+	if (tRet.m_TotalCount > 0)
+	{
+		tRet.m_Min = tMin;
+		tRet.m_Max = tMax;
+		if (tVersion >= 2)
+			memcpy(&tRet.m_Sum, &tSumBits, sizeof(tSumBits));
+	}
+	*this = std::move(tRet);
+	return true;
+}
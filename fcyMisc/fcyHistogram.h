@@ -0,0 +1,110 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyHistogram.h
+/// @brief fancy高动态范围直方图
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class fcyStopWatch;
+
+/// @addtogroup fancy杂项
+/// @{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 高动态范围（HDR）直方图
+/// @note  对数-线性分桶：按2的幂分为若干桶，每个桶内再线性细分，
+///        使任意值的记录误差不超过给定的有效数字位数。内存在构造时一次分配，
+///        记录为O(1)。非线程安全，多线程时每个线程使用各自的实例再合并。
+///        时间类接口以纳秒为单位记录。
+////////////////////////////////////////////////////////////////////////////////
+class fcyHdrHistogram
+{
+private:
+	uint64_t m_HighestTrackable;        ///< @brief 可记录的最大值
+	uint32_t m_SignificantDigits;       ///< @brief 有效数字位数
+	uint32_t m_SubBucketHalfCountMag;   ///< @brief 半桶细分数的对数
+	uint64_t m_SubBucketHalfCount;      ///< @brief 半桶细分数
+	uint64_t m_SubBucketMask;           ///< @brief 桶细分掩码
+	uint32_t m_BucketCount;             ///< @brief 桶数量
+	std::vector<uint64_t> m_Counts;     ///< @brief 计数
+	uint64_t m_TotalCount;              ///< @brief 总计数
+	uint64_t m_SaturatedCount;          ///< @brief 超出范围而被截断的计数
+	uint64_t m_Min;                     ///< @brief 最小值
+	uint64_t m_Max;                     ///< @brief 最大值
+	double m_Sum;                       ///< @brief 总和
+private:
+	void init(uint64_t HighestTrackableValue, uint32_t SignificantDigits);
+	size_t countsIndex(uint64_t Value)const;
+	uint64_t valueFromIndex(size_t Index)const;
+	uint64_t highestEquivalentValue(uint64_t Value)const;
+public:
+	/// @brief     记录一个值
+	/// @note      超过最大可记录值时按最大值记录
+	/// @param[in] Value 值
+	/// @return    值被截断时返回false
+	bool Record(uint64_t Value);
+
+	/// @brief     记录一个值多次
+	/// @param[in] Value 值
+	/// @param[in] Count 次数
+	/// @return    值被截断时返回false
+	bool RecordValues(uint64_t Value, uint64_t Count);
+
+	/// @brief     记录时间
+	/// @param[in] Seconds 秒数，以纳秒记录
+	bool RecordSeconds(double Seconds);
+
+	/// @brief     记录停表的流逝时间
+	/// @param[in] Watch 停表，以纳秒记录
+	bool RecordElapsed(fcyStopWatch& Watch);
+
+	/// @brief 清空计数
+	void Reset();
+
+	/// @brief     合并另一个直方图
+	/// @note      配置不同时按对方每个桶的代表值重新记录
+	/// @param[in] Other 另一个直方图
+	void Merge(const fcyHdrHistogram& Other);
+
+	/// @brief     获得百分位数
+	/// @param[in] Percentile 百分位，范围[0, 100]，如99.9
+	/// @return    不小于该比例样本的最小值（在精度范围内），没有样本时返回0
+	uint64_t GetValueAtPercentile(double Percentile)const;
+
+	/// @brief 获得总计数
+	uint64_t GetTotalCount()const { return m_TotalCount; }
+	/// @brief 获得被截断的计数
+	uint64_t GetSaturatedCount()const { return m_SaturatedCount; }
+	/// @brief 获得最小值，没有样本时返回0
+	uint64_t GetMin()const { return m_TotalCount ? m_Min : 0; }
+	/// @brief 获得最大值
+	uint64_t GetMax()const { return m_Max; }
+	/// @brief 获得平均值
+	double GetMean()const { return m_TotalCount ? m_Sum / double(m_TotalCount) : 0.; }
+	/// @brief 获得最大可记录值
+	uint64_t GetHighestTrackableValue()const { return m_HighestTrackable; }
+	/// @brief 获得有效数字位数
+	uint32_t GetSignificantDigits()const { return m_SignificantDigits; }
+	/// @brief 获得计数所占内存
+	size_t GetMemorySize()const { return m_Counts.size() * sizeof(uint64_t); }
+
+	/// @brief      序列化
+	/// @note       使用变长整数编码，连续的零计数压缩为游程；保存精确的最值与总和
+	/// @param[out] Out 输出数据
+	void Serialize(std::vector<uint8_t>& Out)const;
+
+	/// @brief     反序列化，替换当前内容与配置
+	/// @param[in] pData 数据
+	/// @param[in] Len   字节数
+	/// @return    数据无效时返回false，当前内容不变
+	bool Deserialize(const void* pData, size_t Len);
+public:
+	/// @brief     构造函数
+	/// @param[in] HighestTrackableValue 最大可记录值，默认为60秒（纳秒）
+	/// @param[in] SignificantDigits     有效数字位数，范围[1, 5]
+	fcyHdrHistogram(uint64_t HighestTrackableValue = 60000000000ull, uint32_t SignificantDigits = 3);
+	~fcyHdrHistogram();
+};
+/// @}
@@ -0,0 +1,167 @@
+﻿#include "fcyMappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include "fcyStringHelper.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+fcyMappedFile::fcyMappedFile()
+	: m_pData(nullptr), m_Size(0)
+#ifdef _WIN32
+	, m_hFile(nullptr), m_hMapping(nullptr)
+#endif
+{
+}
+
+fcyMappedFile::fcyMappedFile(fcyMappedFile&& Right)noexcept
+	: fcyMappedFile()
+{
+	*this = move(Right);
+}
+
+fcyMappedFile& fcyMappedFile::operator=(fcyMappedFile&& Right)noexcept
+{
+	if (this != &Right)
+	{
+		Close();
+		swap(m_pData, Right.m_pData);
+		swap(m_Size, Right.m_Size);
+#ifdef _WIN32
+		swap(m_hFile, Right.m_hFile);
+		swap(m_hMapping, Right.m_hMapping);
+#endif
+	}
+	return *this;
+}
+
+fcyMappedFile::~fcyMappedFile()
+{
+	Close();
+}
+
+bool fcyMappedFile::IsOpen()const
+{
+#ifdef _WIN32
+	return m_hFile != nullptr;
+#else
+	return m_pData != nullptr;
+#endif
+}
+
+#ifdef _WIN32
+
+bool fcyMappedFile::Open(const string& Path)
+{
+	Close();
+
+	wstring tPath = fcyStringHelper::MultiByteToWideChar_UTF8(Path);
+	HANDLE hFile = CreateFileW(tPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER tSize;
+	if (!GetFileSizeEx(hFile, &tSize) || (uint64_t)tSize.QuadPart > (uint64_t)SIZE_MAX)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	m_hFile = hFile;
+	m_Size = (size_t)tSize.QuadPart;
+	if (m_Size == 0)
+		return true;
+
+	HANDLE hMapping = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!hMapping)
+	{
+		Close();
+		return false;
+	}
+	m_hMapping = hMapping;
+
+	m_pData = (const char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (!m_pData)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void fcyMappedFile::Close()
+{
+	if (m_pData)
+		UnmapViewOfFile(m_pData);
+	if (m_hMapping)
+		CloseHandle((HANDLE)m_hMapping);
+	if (m_hFile)
+		CloseHandle((HANDLE)m_hFile);
+	m_pData = nullptr;
+	m_hMapping = nullptr;
+	m_hFile = nullptr;
+	m_Size = 0;
+}
+
+#else
+
+// 空文件不映射，用此地址表示已打开
+static const char s_EmptyFile[1] = { 0 };
+
+bool fcyMappedFile::Open(const string& Path)
+{
+	Close();
+
+	int tFD = ::open(Path.c_str(), O_RDONLY);
+	if (tFD < 0)
+		return false;
+
+	struct stat tStat;
+	if (fstat(tFD, &tStat) != 0 || !S_ISREG(tStat.st_mode))
+	{
+		::close(tFD);
+		return false;
+	}
+
+	if (tStat.st_size == 0)
+	{
+		::close(tFD);
+		m_pData = s_EmptyFile;
+		m_Size = 0;
+		return true;
+	}
+
+	void* p = mmap(nullptr, (size_t)tStat.st_size, PROT_READ, MAP_PRIVATE, tFD, 0);
+	::close(tFD);  // 映射建立后不再需要描述符
+	if (p == MAP_FAILED)
+		return false;
+
+	madvise(p, (size_t)tStat.st_size, MADV_SEQUENTIAL);
+	m_pData = (const char*)p;
+	m_Size = (size_t)tStat.st_size;
+	return true;
+}
+
+void fcyMappedFile::Close()
+{
+	if (m_pData && m_pData != s_EmptyFile)
+		munmap((void*)m_pData, m_Size);
+	m_pData = nullptr;
+	m_Size = 0;
+}
+
+#endif
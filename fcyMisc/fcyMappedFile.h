@@ -0,0 +1,53 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyMappedFile.h
+/// @brief fancy只读内存映射文件
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/// @addtogroup fancy杂项
+/// @{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 只读内存映射文件
+/// @note  映射在对象销毁或Close时解除，期间GetView返回的视图保持有效。
+////////////////////////////////////////////////////////////////////////////////
+class fcyMappedFile
+{
+private:
+	const char* m_pData;  ///< @brief 映射地址
+	size_t m_Size;        ///< @brief 文件大小
+#ifdef _WIN32
+	void* m_hFile;        ///< @brief 文件句柄
+	void* m_hMapping;     ///< @brief 映射句柄
+#endif
+public:
+	/// @brief     打开并映射文件
+	/// @note      空文件视为成功，视图为空
+	/// @param[in] Path 文件路径，UTF-8编码
+	/// @return    失败返回false
+	bool Open(const std::string& Path);
+
+	/// @brief 解除映射并关闭文件
+	void Close();
+
+	/// @brief 是否已打开
+	bool IsOpen()const;
+
+	/// @brief 获得文件内容
+	std::string_view GetView()const { return std::string_view(m_pData, m_Size); }
+
+	/// @brief 获得文件大小
+	size_t GetSize()const { return m_Size; }
+public:
+	fcyMappedFile();
+	fcyMappedFile(fcyMappedFile&& Right)noexcept;
+	fcyMappedFile& operator=(fcyMappedFile&& Right)noexcept;
+	~fcyMappedFile();
+private:
+	fcyMappedFile(const fcyMappedFile&) = delete;
+	fcyMappedFile& operator=(const fcyMappedFile&) = delete;
+};
+/// @}
@@ -0,0 +1,190 @@
+﻿#include "fcyPerfCounter.h"
+
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define FCY_PERFCOUNTER_LINUX
+#endif
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const char* HardwareCounterName[fcyPerfCounterGroup::CounterCount] =
+{
+	"cycles", "instructions", "cache-misses", "branch-misses"
+};
+
+static const char* SoftwareCounterName[fcyPerfCounterGroup::CounterCount] =
+{
+	"task-clock-ns", "page-faults", "context-switches", "cpu-migrations"
+};
+
+#ifdef FCY_PERFCOUNTER_LINUX
+static int OpenEvent(uint32_t Type, uint64_t Config, int GroupFD, bool ExcludeKernel)
+{
+	perf_event_attr tAttr;
+	memset(&tAttr, 0, sizeof(tAttr));
+	tAttr.size = sizeof(tAttr);
+	tAttr.type = Type;
+	tAttr.config = Config;
+	tAttr.disabled = GroupFD < 0 ? 1 : 0;
+	tAttr.exclude_kernel = ExcludeKernel ? 1 : 0;
+	tAttr.exclude_hv = 1;
+	tAttr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return (int)syscall(__NR_perf_event_open, &tAttr, 0, -1, GroupFD, 0);
+}
+#endif
+
+fcyPerfCounterGroup& fcyPerfCounterGroup::GetThreadInstance()
+{
+	static thread_local fcyPerfCounterGroup s_Instance;
+	return s_Instance;
+}
+
+fcyPerfCounterGroup::fcyPerfCounterGroup(bool AllowHardware)
+	: m_Mode(Mode_Unavailable), m_OpenCount(0)
+{
+	for (uint32_t i = 0; i < CounterCount; ++i)
+	{
+		m_FD[i] = -1;
+		m_FDIndex[i] = 0;
+	}
+
+	if (!(AllowHardware && open(Mode_Hardware)))
+		open(Mode_Software);
+	Reset();
+}
+
+fcyPerfCounterGroup::~fcyPerfCounterGroup()
+{
+	close();
+}
+
+bool fcyPerfCounterGroup::open(Mode TargetMode)
+{
+#ifdef FCY_PERFCOUNTER_LINUX
+	static const uint64_t tHardware[CounterCount] =
+	{
+		PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+	};
+	static const uint64_t tSoftware[CounterCount] =
+	{
+		PERF_COUNT_SW_TASK_CLOCK, PERF_COUNT_SW_PAGE_FAULTS, PERF_COUNT_SW_CONTEXT_SWITCHES, PERF_COUNT_SW_CPU_MIGRATIONS
+	};
+
+	const bool tHW = TargetMode == Mode_Hardware;
+	const uint32_t tType = tHW ? PERF_TYPE_HARDWARE : PERF_TYPE_SOFTWARE;
+	const uint64_t* pConfig = tHW ? tHardware : tSoftware;
+
+	// 上下文切换与CPU迁移在内核态计数，排除内核时恒为0；
+	// 权限不足（perf_event_paranoid）以致无法打开时标记为不可用，而不是退回到恒为0的计数
+	auto tExcludeKernel = [&](uint32_t i) {
+		return tHW || (pConfig[i] != PERF_COUNT_SW_CONTEXT_SWITCHES && pConfig[i] != PERF_COUNT_SW_CPU_MIGRATIONS);
+	};
+
+	// 组长不可用时整组不可用，其余计数器允许单独缺失
+	int tLeader = OpenEvent(tType, pConfig[0], -1, tExcludeKernel(0));
+	if (tLeader < 0)
+		return false;
+
+	m_FD[0] = tLeader;
+	m_FDIndex[0] = 0;
+	m_OpenCount = 1;
+	for (uint32_t i = 1; i < CounterCount; ++i)
+	{
+		m_FD[i] = OpenEvent(tType, pConfig[i], tLeader, tExcludeKernel(i));
+		if (m_FD[i] >= 0)
+			m_FDIndex[i] = m_OpenCount++;
+	}
+
+	ioctl(tLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(tLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	m_Mode = TargetMode;
+	return true;
+#else
+	(void)TargetMode;
+	return false;
+#endif
+}
+
+void fcyPerfCounterGroup::close()
+{
+#ifdef FCY_PERFCOUNTER_LINUX
+	for (uint32_t i = CounterCount; i > 0; --i)
+	{
+		if (m_FD[i - 1] >= 0)
+			::close(m_FD[i - 1]);
+		m_FD[i - 1] = -1;
+	}
+#endif
+	m_OpenCount = 0;
+	m_Mode = Mode_Unavailable;
+}
+
+void fcyPerfCounterGroup::read(Values& Out)const
+{
+	memset(&Out, 0, sizeof(Out));
+
+#ifdef FCY_PERFCOUNTER_LINUX
+	if (m_Mode == Mode_Unavailable)
+		return;
+
+	// 布局：nr, time_enabled, time_running, value[nr]
+	uint64_t tBuf[3 + CounterCount];
+	ssize_t tSize = ::read(m_FD[0], tBuf, sizeof(tBuf));
+	if (tSize < (ssize_t)(3 * sizeof(uint64_t)) || tBuf[0] != m_OpenCount)
+		return;
+
+	double tScale = 1.;
+	if (tBuf[2] > 0 && tBuf[2] < tBuf[1])
+		tScale = double(tBuf[1]) / double(tBuf[2]);
+
+	for (uint32_t i = 0; i < CounterCount; ++i)
+	{
+		if (m_FD[i] < 0)
+			continue;
+		uint64_t tValue = tBuf[3 + m_FDIndex[i]];
+		Out.Value[i] = tScale == 1. ? tValue : (uint64_t)(double(tValue) * tScale);
+	}
+#endif
+}
+
+const char* fcyPerfCounterGroup::GetCounterName(uint32_t Index)const
+{
+	if (Index >= CounterCount)
+		return "";
+	return m_Mode == Mode_Software ? SoftwareCounterName[Index] : HardwareCounterName[Index];
+}
+
+void fcyPerfCounterGroup::Pause()
+{
+	read(m_FixStart);
+}
+
+void fcyPerfCounterGroup::Resume()
+{
+	Values tNow;
+	read(tNow);
+	for (uint32_t i = 0; i < CounterCount; ++i)
+		m_FixAll.Value[i] += tNow.Value[i] - m_FixStart.Value[i];
+}
+
+void fcyPerfCounterGroup::Reset()
+{
+	memset(&m_FixAll, 0, sizeof(m_FixAll));
+	memset(&m_FixStart, 0, sizeof(m_FixStart));
+	read(m_Last);
+}
+
+void fcyPerfCounterGroup::GetElapsed(Values& Out)
+{
+	read(Out);
+	for (uint32_t i = 0; i < CounterCount; ++i)
+		Out.Value[i] -= m_Last.Value[i] + m_FixAll.Value[i];
+}
@@ -0,0 +1,81 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyPerfCounter.h
+/// @brief fancy硬件性能计数器
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+
+/// @addtogroup fancy杂项
+/// @{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 性能计数器组
+/// @note  Linux下基于perf_event_open统计调用线程的用户态事件。
+///        硬件模式统计周期数、指令数、缓存未命中与分支预测失败；
+///        硬件PMU不可用时（如虚拟机中）退回软件模式，统计任务时钟（纳秒）、缺页、
+///        上下文切换与CPU迁移；后两者发生在内核态，需要允许统计内核事件，
+///        权限不足时这两个计数器不可用（IsCounterAvailable返回false）。其他平台不可用，所有值为0。
+///        Pause、Resume、Reset与fcyStopWatch语义一致。计数器只统计创建它的线程。
+////////////////////////////////////////////////////////////////////////////////
+class fcyPerfCounterGroup
+{
+public:
+	static const uint32_t CounterCount = 4; ///< @brief 计数器数量
+
+	/// @brief 工作模式
+	enum Mode
+	{
+		Mode_Unavailable, ///< @brief 不可用
+		Mode_Hardware,    ///< @brief 硬件计数器
+		Mode_Software     ///< @brief 软件计数器
+	};
+
+	/// @brief 计数器读数
+	struct Values
+	{
+		uint64_t Value[CounterCount];
+	};
+private:
+	Mode m_Mode;                  ///< @brief 工作模式
+	int m_FD[CounterCount];       ///< @brief 事件描述符，首个为组长，-1表示该计数器不可用
+	uint32_t m_FDIndex[CounterCount]; ///< @brief 计数器在组读数中的下标
+	uint32_t m_OpenCount;         ///< @brief 已打开的计数器数量
+	Values m_Last;                ///< @brief 上一次时间
+	Values m_FixStart;            ///< @brief 暂停时的修复参数
+	Values m_FixAll;              ///< @brief 暂停时的修复参数
+private:
+	bool open(Mode TargetMode);
+	void close();
+	void read(Values& Out)const;
+public:
+	/// @brief 获得工作模式
+	Mode GetMode()const { return m_Mode; }
+	/// @brief 是否可用
+	bool IsAvailable()const { return m_Mode != Mode_Unavailable; }
+	/// @brief 计数器是否可用
+	bool IsCounterAvailable(uint32_t Index)const { return Index < CounterCount && m_FD[Index] >= 0; }
+	/// @brief 获得计数器名称，随工作模式变化
+	const char* GetCounterName(uint32_t Index)const;
+
+	void Pause();   ///< @brief 暂停
+	void Resume();  ///< @brief 继续
+	void Reset();   ///< @brief 归零
+
+	/// @brief      获得自Reset以来（不含暂停期间）的计数
+	/// @note       计数器被内核复用时按启用时间比例估算
+	/// @param[out] Out 计数
+	void GetElapsed(Values& Out);
+
+	/// @brief 获得当前线程的计数器组
+	/// @note  首次调用时创建，供分析器区段使用
+	static fcyPerfCounterGroup& GetThreadInstance();
+public:
+	/// @brief     构造函数
+	/// @param[in] AllowHardware 为false时直接使用软件模式
+	fcyPerfCounterGroup(bool AllowHardware = true);
+	~fcyPerfCounterGroup();
+private:
+	fcyPerfCounterGroup(const fcyPerfCounterGroup&) = delete;
+	fcyPerfCounterGroup& operator=(const fcyPerfCounterGroup&) = delete;
+};
+/// @}
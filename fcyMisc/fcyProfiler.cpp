@@ -0,0 +1,396 @@
+﻿#include "fcyProfiler.h"
+#include "fcyStopWatch.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static void WriteJsonString(ostream& Out, const char* Str)
+{
+	Out << '"';
+	for (const char* p = Str; *p; ++p)
+	{
+		char c = *p;
+		if (c == '"' || c == '\\')
+			Out << '\\' << c;
+		else if ((unsigned char)c < 0x20)
+		{
+			char tBuf[8];
+			snprintf(tBuf, sizeof(tBuf), "\\u%04x", (unsigned)c);
+			Out << tBuf;
+		}
+		else
+			Out << c;
+	}
+	Out << '"';
+}
+
+fcyProfiler& fcyProfiler::GetInstance()
+{
+	static fcyProfiler s_Instance;
+	return s_Instance;
+}
+
+fcyProfiler::fcyProfiler()
+	: m_Enabled(true), m_BufferCapacity(1u << 14), m_NextThreadID(0), m_RetiredDropped(0),
+	m_Capturing(false), m_MaxCaptureEvents(0)
+{
+}
+
+fcyProfiler::~fcyProfiler()
+{
+}
+
+// 缓存的空闲缓冲区上限，超出部分直接释放
+static const size_t MaxFreeBuffers = 16;
+
+fcyProfiler::ThreadBufferOwner::~ThreadBufferOwner()
+{
+	// 置空线程局部指针，之后其他线程局部对象析构时若再进入区段会重新注册
+	if (Slot && *Slot)
+	{
+		(*Slot)->Retired.store(true, memory_order_release);
+		*Slot = nullptr;
+	}
+}
+
+fcyProfiler::ThreadBuffer* fcyProfiler::registerThread()
+{
+	lock_guard<mutex> tLock(m_RegisterLock);
+
+	unique_ptr<ThreadBuffer> tBuffer;
+	while (!m_FreeBuffers.empty() && !tBuffer)
+	{
+		// 容量已改变的空闲缓冲区不再复用
+		if (m_FreeBuffers.back()->Events.size() == m_BufferCapacity)
+			tBuffer = move(m_FreeBuffers.back());
+		m_FreeBuffers.pop_back();
+	}
+	if (!tBuffer)
+	{
+		tBuffer.reset(new ThreadBuffer());
+		tBuffer->Events.resize(m_BufferCapacity);
+		tBuffer->Mask = m_BufferCapacity - 1;
+	}
+
+	tBuffer->ThreadID = m_NextThreadID++;
+	tBuffer->ThreadName.clear();
+	tBuffer->Head.store(0, memory_order_relaxed);
+	tBuffer->Tail.store(0, memory_order_relaxed);
+	tBuffer->Depth = 0;
+	tBuffer->SkipDepth = 0;
+	tBuffer->Dropped.store(0, memory_order_relaxed);
+	tBuffer->Retired.store(false, memory_order_relaxed);
+	tBuffer->Stack.clear();
+
+	m_Buffers.push_back(move(tBuffer));
+	return m_Buffers.back().get();
+}
+
+fcyProfiler::ThreadBuffer* fcyProfiler::getThreadBuffer()
+{
+	static thread_local ThreadBuffer* s_pBuffer = nullptr;
+	if (!s_pBuffer)
+	{
+		// 拥有者只在注册时访问，热路径上不产生线程局部对象的初始化检查
+		static thread_local ThreadBufferOwner s_Owner = { &s_pBuffer };
+		(void)s_Owner;
+		s_pBuffer = GetInstance().registerThread();
+	}
+	return s_pBuffer;
+}
+
+void fcyProfiler::BeginZone(const char* Name)
+{
+	ThreadBuffer* p = getThreadBuffer();
+
+	// 未记录的区段计入SkipDepth，保证结束事件与开始事件一一对应
+	if (p->SkipDepth == 0 && GetInstance().IsEnabled())
+	{
+		uint64_t tHead = p->Head.load(memory_order_relaxed);
+		uint64_t tTail = p->Tail.load(memory_order_acquire);
+		// 为所有未结束的区段预留结束事件的位置
+		if (tHead - tTail + p->Depth + 2 <= p->Mask + 1)
+		{
+			Event& tEvent = p->Events[tHead & p->Mask];
+			tEvent.Name = Name;
+			tEvent.Timestamp = fcyStopWatch::GetTimestamp();
+			p->Head.store(tHead + 1, memory_order_release);
+			++p->Depth;
+			return;
+		}
+		p->Dropped.fetch_add(1, memory_order_relaxed);
+	}
+	++p->SkipDepth;
+}
+
+void fcyProfiler::EndZone()
+{
+	uint64_t tNow = fcyStopWatch::GetTimestamp();
+	ThreadBuffer* p = getThreadBuffer();
+
+	if (p->SkipDepth > 0)
+	{
+		--p->SkipDepth;
+		return;
+	}
+	if (p->Depth == 0)
+		return;
+
+	uint64_t tHead = p->Head.load(memory_order_relaxed);
+	Event& tEvent = p->Events[tHead & p->Mask];
+	tEvent.Name = nullptr;
+	tEvent.Timestamp = tNow;
+	p->Head.store(tHead + 1, memory_order_release);
+	--p->Depth;
+}
+
+void fcyProfiler::SetBufferCapacity(uint32_t Capacity)
+{
+	uint32_t tCapacity = 64;
+	while (tCapacity < Capacity && tCapacity < (1u << 30))
+		tCapacity <<= 1;
+
+	lock_guard<mutex> tLock(m_RegisterLock);
+	m_BufferCapacity = tCapacity;
+}
+
+void fcyProfiler::SetThreadName(const char* Name)
+{
+	ThreadBuffer* p = getThreadBuffer();
+
+	lock_guard<mutex> tLock(m_RegisterLock);
+	p->ThreadName = Name ? Name : "";
+}
+
+void fcyProfiler::drain(ThreadBuffer* pBuffer)
+{
+	uint64_t tTail = pBuffer->Tail.load(memory_order_relaxed);
+	uint64_t tHead = pBuffer->Head.load(memory_order_acquire);
+
+	for (; tTail != tHead; ++tTail)
+	{
+		const Event& tEvent = pBuffer->Events[tTail & pBuffer->Mask];
+
+		if (tEvent.Name)
+		{
+			pBuffer->Stack.push_back(OpenZone { tEvent.Name, tEvent.Timestamp, 0 });
+			continue;
+		}
+		if (pBuffer->Stack.empty())
+			continue;
+
+		OpenZone tZone = pBuffer->Stack.back();
+		pBuffer->Stack.pop_back();
+		uint64_t tTotal = tEvent.Timestamp - tZone.Start;
+		if (!pBuffer->Stack.empty())
+			pBuffer->Stack.back().ChildTicks += tTotal;
+
+		if (m_Capturing)
+		{
+			if (m_Captured.size() < m_MaxCaptureEvents)
+				m_Captured.push_back(CapturedEvent { tZone.Name, tZone.Start, tEvent.Timestamp, pBuffer->ThreadID });
+			else
+				m_Capturing = false;
+		}
+
+		auto i = m_StatIndex.find(tZone.Name);
+		if (i == m_StatIndex.end())
+		{
+			i = m_StatIndex.emplace(tZone.Name, (uint32_t)m_FrameStats.size()).first;
+			m_FrameStats.push_back(ZoneStat { tZone.Name, 0, 0, 0 });
+		}
+		ZoneStat& tStat = m_FrameStats[i->second];
+		++tStat.Count;
+		tStat.TotalTicks += tTotal;
+		tStat.SelfTicks += tTotal - min(tTotal, tZone.ChildTicks);
+	}
+
+	pBuffer->Tail.store(tTail, memory_order_release);
+}
+
+void fcyProfiler::recycleRetired()
+{
+	// 调用方须持有m_CollectLock，退役缓冲区的事件已全部汇总
+	lock_guard<mutex> tLock(m_RegisterLock);
+
+	size_t tCount = 0;
+	for (size_t i = 0; i < m_Buffers.size(); ++i)
+	{
+		unique_ptr<ThreadBuffer>& p = m_Buffers[i];
+		if (!p->Retired.load(memory_order_acquire) ||
+			p->Tail.load(memory_order_relaxed) != p->Head.load(memory_order_acquire))
+		{
+			if (tCount != i)
+				m_Buffers[tCount] = move(p);
+			++tCount;
+			continue;
+		}
+
+		m_RetiredDropped += p->Dropped.load(memory_order_relaxed);
+		if (!p->ThreadName.empty() && (m_Capturing || !m_Captured.empty()))
+			m_RetiredNames.emplace_back(p->ThreadID, move(p->ThreadName));
+		if (m_FreeBuffers.size() < MaxFreeBuffers)
+			m_FreeBuffers.push_back(move(p));
+		else
+			p.reset();
+	}
+	m_Buffers.resize(tCount);
+}
+
+void fcyProfiler::EndFrame()
+{
+	lock_guard<mutex> tCollectLock(m_CollectLock);
+
+	m_FrameStats.clear();
+	m_StatIndex.clear();
+
+	vector<ThreadBuffer*> tBuffers;
+	bool tAnyRetired = false;
+	{
+		lock_guard<mutex> tLock(m_RegisterLock);
+		tBuffers.reserve(m_Buffers.size());
+		for (auto& i : m_Buffers)
+			tBuffers.push_back(i.get());
+	}
+
+	// 先读取退役标记再汇总，保证退役线程的全部事件都已被汇总
+	for (auto p : tBuffers)
+	{
+		tAnyRetired |= p->Retired.load(memory_order_acquire);
+		drain(p);
+	}
+	if (tAnyRetired)
+		recycleRetired();
+
+	lock_guard<mutex> tCounterLock(m_CounterLock);
+	m_FrameCounterStats.swap(m_CounterAccum);
+	m_CounterAccum.clear();
+	m_CounterIndex.clear();
+}
+
+void fcyProfiler::SubmitCounters(const char* Name, const fcyPerfCounterGroup::Values& Delta)
+{
+	lock_guard<mutex> tLock(m_CounterLock);
+
+	auto i = m_CounterIndex.find(Name);
+	if (i == m_CounterIndex.end())
+	{
+		i = m_CounterIndex.emplace(Name, (uint32_t)m_CounterAccum.size()).first;
+		m_CounterAccum.push_back(ZoneCounterStat { Name, 0, { 0 } });
+	}
+
+	ZoneCounterStat& tStat = m_CounterAccum[i->second];
+	++tStat.Count;
+	for (uint32_t j = 0; j < fcyPerfCounterGroup::CounterCount; ++j)
+		tStat.Value[j] += Delta.Value[j];
+}
+
+uint64_t fcyProfiler::GetDroppedCount()
+{
+	lock_guard<mutex> tLock(m_RegisterLock);
+
+	uint64_t tRet = m_RetiredDropped;
+	for (auto& i : m_Buffers)
+		tRet += i->Dropped.load(memory_order_relaxed);
+	return tRet;
+}
+
+void fcyProfiler::BeginCapture(size_t MaxEvents)
+{
+	lock_guard<mutex> tLock(m_CollectLock);
+
+	m_Captured.clear();
+	m_MaxCaptureEvents = MaxEvents;
+	{
+		lock_guard<mutex> tRegisterLock(m_RegisterLock);
+		m_RetiredNames.clear();
+	}
+	m_Capturing = true;
+}
+
+void fcyProfiler::EndCapture()
+{
+	lock_guard<mutex> tLock(m_CollectLock);
+
+	m_Capturing = false;
+}
+
+void fcyProfiler::ExportChromeTrace(ostream& Out)
+{
+	lock_guard<mutex> tCollectLock(m_CollectLock);
+
+	Out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool tFirst = true;
+	{
+		lock_guard<mutex> tLock(m_RegisterLock);
+		for (auto& i : m_Buffers)
+		{
+			if (i->ThreadName.empty())
+				continue;
+			if (!tFirst)
+				Out << ',';
+			tFirst = false;
+			Out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i->ThreadID << ",\"args\":{\"name\":";
+			WriteJsonString(Out, i->ThreadName.c_str());
+			Out << "}}";
+		}
+		for (auto& i : m_RetiredNames)
+		{
+			if (!tFirst)
+				Out << ',';
+			tFirst = false;
+			Out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i.first << ",\"args\":{\"name\":";
+			WriteJsonString(Out, i.second.c_str());
+			Out << "}}";
+		}
+	}
+
+	uint64_t tBase = m_Captured.empty() ? 0 : m_Captured.front().Start;
+	for (auto& i : m_Captured)
+		tBase = min(tBase, i.Start);
+
+	char tTime[64];
+	for (auto& i : m_Captured)
+	{
+		if (!tFirst)
+			Out << ',';
+		tFirst = false;
+
+		// 时间戳与持续时间以微秒为单位
+		snprintf(tTime, sizeof(tTime), "\"ts\":%.3f,\"dur\":%.3f",
+			fcyStopWatch::TicksToSeconds(i.Start - tBase) * 1e6, fcyStopWatch::TicksToSeconds(i.End - i.Start) * 1e6);
+		Out << "\n{\"name\":";
+		WriteJsonString(Out, i.Name);
+		Out << ",\"ph\":\"X\"," << tTime << ",\"pid\":0,\"tid\":" << i.ThreadID << '}';
+	}
+
+	Out << "\n]}\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+fcyProfileCounterZone::fcyProfileCounterZone(const char* Name)
+	: m_Name(Name), m_Active(fcyProfiler::GetInstance().IsEnabled())
+{
+	fcyProfiler::BeginZone(Name);
+	if (m_Active)
+		fcyPerfCounterGroup::GetThreadInstance().GetElapsed(m_Start);
+}
+
+fcyProfileCounterZone::~fcyProfileCounterZone()
+{
+	if (m_Active)
+	{
+		fcyPerfCounterGroup::Values tDelta;
+		fcyPerfCounterGroup::GetThreadInstance().GetElapsed(tDelta);
+		for (uint32_t i = 0; i < fcyPerfCounterGroup::CounterCount; ++i)
+			tDelta.Value[i] -= m_Start.Value[i];
+		fcyProfiler::GetInstance().SubmitCounters(m_Name, tDelta);
+	}
+	fcyProfiler::EndZone();
+}
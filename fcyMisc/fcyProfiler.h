@@ -0,0 +1,238 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyProfiler.h
+/// @brief fancy分段性能分析器
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "fcyPerfCounter.h"
+
+/// @addtogroup fancy杂项
+/// @{
+
+/// @brief 为0时FCY_PROFILE_*宏展开为空
+#ifndef FCY_PROFILER_ENABLED
+#define FCY_PROFILER_ENABLED 0
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 分段性能分析器
+/// @note  每个线程拥有一个单生产者单消费者的无锁环形缓冲区，记录区段的开始与结束事件，
+///        时间戳来自fcyStopWatch::GetTimestamp。EndFrame在一处汇总所有线程的事件，
+///        统计每个区段在本帧的调用次数、总时间与自身时间，并可录制为Chrome trace_event格式。
+///        区段名称须为静态字符串，以指针区分。
+///        线程退出后其缓冲区在下一次EndFrame汇总完剩余事件后回收，供新线程复用。
+////////////////////////////////////////////////////////////////////////////////
+class fcyProfiler
+{
+public:
+	/// @brief 区段统计
+	struct ZoneStat
+	{
+		const char* Name;     ///< @brief 区段名称
+		uint32_t Count;       ///< @brief 调用次数
+		uint64_t TotalTicks;  ///< @brief 总时间（计时周期）
+		uint64_t SelfTicks;   ///< @brief 除去子区段的时间（计时周期）
+	};
+
+	/// @brief 区段性能计数器统计
+	/// @note  计数器含义见fcyPerfCounterGroup::GetCounterName，包含子区段
+	struct ZoneCounterStat
+	{
+		const char* Name;                                   ///< @brief 区段名称
+		uint32_t Count;                                     ///< @brief 调用次数
+		uint64_t Value[fcyPerfCounterGroup::CounterCount];  ///< @brief 计数总和
+	};
+private:
+	/// @brief 事件，Name为空时表示区段结束
+	struct Event
+	{
+		const char* Name;
+		uint64_t Timestamp;
+	};
+
+	/// @brief 汇总时未结束的区段
+	struct OpenZone
+	{
+		const char* Name;
+		uint64_t Start;
+		uint64_t ChildTicks;
+	};
+
+	/// @brief 线程缓冲区
+	struct ThreadBuffer
+	{
+		uint32_t ThreadID;                  ///< @brief 分析器内的线程编号
+		std::string ThreadName;             ///< @brief 线程名称
+		std::vector<Event> Events;          ///< @brief 环形缓冲，容量为2的幂
+		uint64_t Mask;                      ///< @brief 容量-1
+		std::atomic<uint64_t> Head;         ///< @brief 写位置，仅生产者修改
+		std::atomic<uint64_t> Tail;         ///< @brief 读位置，仅消费者修改
+		uint32_t Depth;                     ///< @brief 生产者侧已记录且未结束的区段深度
+		uint32_t SkipDepth;                 ///< @brief 生产者侧因缓冲区满而丢弃的区段深度
+		std::atomic<uint64_t> Dropped;      ///< @brief 丢弃的区段数
+		std::atomic<bool> Retired;          ///< @brief 所属线程已退出
+		std::vector<OpenZone> Stack;        ///< @brief 消费者侧的区段栈
+	};
+
+	/// @brief 线程退出时将缓冲区标记为退役
+	struct ThreadBufferOwner
+	{
+		ThreadBuffer** Slot;  ///< @brief 线程局部的缓冲区指针
+		~ThreadBufferOwner();
+	};
+
+	/// @brief 录制的区段，结束时才记录，保证开始与结束成对
+	struct CapturedEvent
+	{
+		const char* Name;
+		uint64_t Start;
+		uint64_t End;
+		uint32_t ThreadID;
+	};
+private:
+	std::atomic<bool> m_Enabled;                          ///< @brief 是否记录
+	uint32_t m_BufferCapacity;                            ///< @brief 新线程缓冲区容量
+	std::mutex m_RegisterLock;                            ///< @brief 线程注册锁
+	std::vector<std::unique_ptr<ThreadBuffer>> m_Buffers; ///< @brief 活动线程缓冲区
+	std::vector<std::unique_ptr<ThreadBuffer>> m_FreeBuffers; ///< @brief 可复用的缓冲区
+	uint32_t m_NextThreadID;                              ///< @brief 下一个线程编号
+	uint64_t m_RetiredDropped;                            ///< @brief 已退役缓冲区丢弃的区段数
+	std::vector<std::pair<uint32_t, std::string>> m_RetiredNames; ///< @brief 录制期间退出的线程名称
+	std::mutex m_CollectLock;                             ///< @brief 汇总锁
+	std::vector<ZoneStat> m_FrameStats;                   ///< @brief 上一帧的统计
+	std::unordered_map<const char*, uint32_t> m_StatIndex;///< @brief 名称到统计下标
+	bool m_Capturing;                                     ///< @brief 是否录制
+	size_t m_MaxCaptureEvents;                            ///< @brief 录制事件上限
+	std::vector<CapturedEvent> m_Captured;                ///< @brief 录制的事件
+	std::mutex m_CounterLock;                             ///< @brief 计数器统计锁
+	std::vector<ZoneCounterStat> m_CounterAccum;          ///< @brief 本帧累计的计数器统计
+	std::unordered_map<const char*, uint32_t> m_CounterIndex; ///< @brief 名称到计数器统计下标
+	std::vector<ZoneCounterStat> m_FrameCounterStats;     ///< @brief 上一帧的计数器统计
+private:
+	ThreadBuffer* registerThread();
+	static ThreadBuffer* getThreadBuffer();
+	void drain(ThreadBuffer* pBuffer);
+	void recycleRetired();
+public:
+	/// @brief 获得分析器实例
+	static fcyProfiler& GetInstance();
+
+	/// @brief     开始区段
+	/// @param[in] Name 静态字符串名称
+	static void BeginZone(const char* Name);
+
+	/// @brief 结束最近开始的区段
+	static void EndZone();
+
+	/// @brief 设置是否记录
+	void SetEnabled(bool Enabled) { m_Enabled.store(Enabled, std::memory_order_relaxed); }
+	/// @brief 是否记录
+	bool IsEnabled()const { return m_Enabled.load(std::memory_order_relaxed); }
+
+	/// @brief     设置新线程缓冲区的事件容量
+	/// @note      向上取整到2的幂，只影响之后注册的线程
+	void SetBufferCapacity(uint32_t Capacity);
+
+	/// @brief     设置当前线程在导出中的名称
+	/// @param[in] Name 线程名称
+	void SetThreadName(const char* Name);
+
+	/// @brief 结束一帧，汇总所有线程的事件
+	/// @note  跨帧的区段计入结束时所在的帧
+	void EndFrame();
+
+	/// @brief 获得上一帧的区段统计
+	/// @note  仅在调用EndFrame的线程上使用
+	const std::vector<ZoneStat>& GetFrameStats()const { return m_FrameStats; }
+
+	/// @brief     提交区段的性能计数器增量
+	/// @note      由fcyProfileCounterZone调用，计入当前帧
+	/// @param[in] Name  静态字符串名称
+	/// @param[in] Delta 计数器增量
+	void SubmitCounters(const char* Name, const fcyPerfCounterGroup::Values& Delta);
+
+	/// @brief 获得上一帧的区段性能计数器统计
+	/// @note  仅在调用EndFrame的线程上使用
+	const std::vector<ZoneCounterStat>& GetFrameCounterStats()const { return m_FrameCounterStats; }
+
+	/// @brief 获得因缓冲区满而丢弃的区段总数
+	uint64_t GetDroppedCount();
+
+	/// @brief     开始录制
+	/// @note      录制在EndFrame汇总时结束的区段，跨越录制开始的区段保留其真实开始时间，
+	///            录制结束时仍未结束的区段不被记录
+	/// @param[in] MaxEvents 区段数上限，超出后停止记录
+	void BeginCapture(size_t MaxEvents = 1u << 20);
+
+	/// @brief 停止录制，已录制的事件保留到下次BeginCapture
+	void EndCapture();
+
+	/// @brief     以Chrome trace_event JSON格式导出录制的事件
+	/// @note      每个区段导出为一个完整事件（"ph":"X"），可在chrome://tracing或Perfetto中打开
+	/// @param[in] Out 输出流
+	void ExportChromeTrace(std::ostream& Out);
+private:
+	fcyProfiler();
+	~fcyProfiler();
+	fcyProfiler(const fcyProfiler&) = delete;
+	fcyProfiler& operator=(const fcyProfiler&) = delete;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 区段作用域
+////////////////////////////////////////////////////////////////////////////////
+class fcyProfileZone
+{
+public:
+	explicit fcyProfileZone(const char* Name) { fcyProfiler::BeginZone(Name); }
+	~fcyProfileZone() { fcyProfiler::EndZone(); }
+private:
+	fcyProfileZone(const fcyProfileZone&) = delete;
+	fcyProfileZone& operator=(const fcyProfileZone&) = delete;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 带性能计数器的区段作用域
+/// @note  除计时外还读取当前线程的fcyPerfCounterGroup，每次读取为一次系统调用，
+///        只适合粒度较粗的区段
+////////////////////////////////////////////////////////////////////////////////
+class fcyProfileCounterZone
+{
+private:
+	const char* m_Name;                   ///< @brief 区段名称
+	bool m_Active;                        ///< @brief 开始时是否在记录
+	fcyPerfCounterGroup::Values m_Start;  ///< @brief 开始时的计数
+public:
+	explicit fcyProfileCounterZone(const char* Name);
+	~fcyProfileCounterZone();
+private:
+	fcyProfileCounterZone(const fcyProfileCounterZone&) = delete;
+	fcyProfileCounterZone& operator=(const fcyProfileCounterZone&) = delete;
+};
+
+#if FCY_PROFILER_ENABLED
+#define FCY_PROFILE_CONCAT_IMPL(a, b) a##b
+#define FCY_PROFILE_CONCAT(a, b) FCY_PROFILE_CONCAT_IMPL(a, b)
+/// @brief 在当前作用域记录区段
+#define FCY_PROFILE_ZONE(Name) fcyProfileZone FCY_PROFILE_CONCAT(_fcyProfileZone, __LINE__)(Name)
+/// @brief 在当前作用域记录区段及性能计数器
+#define FCY_PROFILE_ZONE_COUNTERS(Name) fcyProfileCounterZone FCY_PROFILE_CONCAT(_fcyProfileZone, __LINE__)(Name)
+/// @brief 以函数名记录区段
+#define FCY_PROFILE_FUNCTION() FCY_PROFILE_ZONE(__FUNCTION__)
+/// @brief 结束一帧
+#define FCY_PROFILE_FRAME() fcyProfiler::GetInstance().EndFrame()
+#else
+#define FCY_PROFILE_ZONE(Name) ((void)0)
+#define FCY_PROFILE_ZONE_COUNTERS(Name) ((void)0)
+#define FCY_PROFILE_FUNCTION() ((void)0)
+#define FCY_PROFILE_FRAME() ((void)0)
+#endif
+/// @}
@@ -1,60 +1,180 @@
 ﻿#include "fcyStopWatch.h"
-#include "cocos2d.h"
-
-#define QUERY(t) QueryPerformanceCounter((LARGE_INTEGER*)&t)
-#define TIME_NOW high_resolution_clock::now().time_since_epoch().count()
 
+// 独立构建时（FCY_STANDALONE）不依赖cocos2d-x，直接检测平台
+#ifdef FCY_STANDALONE
+#if defined(_WIN32)
+#define FCY_PLATFORM_WIN32
+#endif
+#else
+#include "cocos2d.h"
 #if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#define FCY_PLATFORM_WIN32
+#endif
+#endif
+
+#include <chrono>
 
+#ifdef FCY_PLATFORM_WIN32
 // On Windows, this is about 3 times faster.
 #include <Windows.h>
+#define QUERY(t) QueryPerformanceCounter((LARGE_INTEGER*)&t)
+#endif
 
-fcyStopWatch::fcyStopWatch()
-{
-	QueryPerformanceFrequency((LARGE_INTEGER*)&m_cFreq); // 初始化
-	Reset();
-}
+#if !defined(FCY_STOPWATCH_NO_TSC)
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define FCY_STOPWATCH_TSC
+#define CPUID(leaf, r) __cpuid((int*)(r), (int)(leaf))
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#include <cpuid.h>
+#define FCY_STOPWATCH_TSC
+#define CPUID(leaf, r) __cpuid((leaf), (r)[0], (r)[1], (r)[2], (r)[3])
+#endif
+#endif
 
-fcyStopWatch::~fcyStopWatch()
+using namespace std;
+using namespace chrono;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
 {
+	/// @brief 计时源信息
+	struct ClockInfo
+	{
+		bool UseTSC;            ///< @brief 是否使用TSC
+		uint64_t Freq;          ///< @brief 每秒计时周期数
+		double SecondsPerTick;  ///< @brief 每周期秒数
+	};
+
+	// 平台计时源
+	inline uint64_t PlatformNow()
+	{
+#ifdef FCY_PLATFORM_WIN32
+		uint64_t tNow;
+		QUERY(tNow);
+		return tNow;
+#else
+		return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	uint64_t PlatformFrequency()
+	{
+#ifdef FCY_PLATFORM_WIN32
+		uint64_t tFreq;
+		QueryPerformanceFrequency((LARGE_INTEGER*)&tFreq);
+		return tFreq;
+#else
+		return 1000000000ull;
+#endif
+	}
+
+#ifdef FCY_STOPWATCH_TSC
+	// CPUID.80000007H:EDX[8]，不变TSC在变频与深度休眠下保持恒定速率
+	bool HasInvariantTSC()
+	{
+		uint32_t r[4] = { 0 };
+		CPUID(0x80000000u, r);
+		if (r[0] < 0x80000007u)
+			return false;
+		CPUID(0x80000007u, r);
+		return (r[3] & (1u << 8)) != 0;
+	}
+
+	// CPUID.15H直接给出TSC与晶振的比例，多数客户端CPU不提供晶振频率
+	uint64_t QueryTSCFrequency()
+	{
+		uint32_t r[4] = { 0 };
+		CPUID(0, r);
+		if (r[0] < 0x15)
+			return 0;
+		CPUID(0x15, r);
+		if (r[0] == 0 || r[1] == 0 || r[2] == 0)
+			return 0;
+		return (uint64_t)r[2] * r[1] / r[0];
+	}
+
+	// 对照steady_clock测量TSC频率
+	uint64_t MeasureTSCFrequency()
+	{
+		const auto tWindow = milliseconds(5);
+
+		auto tStart = steady_clock::now();
+		uint64_t tTSCStart = __rdtsc();
+		auto tEnd = tStart;
+		uint64_t tTSCEnd;
+		do
+		{
+			tTSCEnd = __rdtsc();
+			tEnd = steady_clock::now();
+		} while (tEnd - tStart < tWindow);
+
+		double tSeconds = duration<double>(tEnd - tStart).count();
+		return (uint64_t)(double(tTSCEnd - tTSCStart) / tSeconds);
+	}
+#endif
+
+	ClockInfo Calibrate()
+	{
+		ClockInfo tInfo;
+		tInfo.UseTSC = false;
+		tInfo.Freq = 0;
+
+#ifdef FCY_STOPWATCH_TSC
+		if (HasInvariantTSC())
+		{
+			tInfo.Freq = QueryTSCFrequency();
+			if (tInfo.Freq == 0)
+				tInfo.Freq = MeasureTSCFrequency();
+			tInfo.UseTSC = tInfo.Freq != 0;
+		}
+#endif
+
+		if (!tInfo.UseTSC)
+			tInfo.Freq = PlatformFrequency();
+		tInfo.SecondsPerTick = 1. / double(tInfo.Freq);
+		return tInfo;
+	}
+
+	// 首次使用时校准，不依赖全局静态对象的初始化顺序
+	inline const ClockInfo& GetClockInfo()
+	{
+		static const ClockInfo s_Info = Calibrate();
+		return s_Info;
+	}
 }
 
-void fcyStopWatch::Pause()
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t fcyStopWatch::GetTimestamp()
 {
-	QUERY(m_cFixStart);
+#ifdef FCY_STOPWATCH_TSC
+	if (GetClockInfo().UseTSC)
+		return __rdtsc();
+#endif
+	return PlatformNow();
 }
 
-void fcyStopWatch::Resume()
+uint64_t fcyStopWatch::GetFrequency()
 {
-	uint64_t tNow;
-	QUERY(tNow);
-	m_cFixAll += tNow - m_cFixStart;
+	return GetClockInfo().Freq;
 }
 
-void fcyStopWatch::Reset()
+double fcyStopWatch::TicksToSeconds(uint64_t Ticks)
 {
-	m_cFixAll = 0;
-	QUERY(m_cLast);
+	return double(Ticks) * GetClockInfo().SecondsPerTick;
 }
 
-double fcyStopWatch::GetElapsed()
+bool fcyStopWatch::IsTSCEnabled()
 {
-	uint64_t tNow;
-	QUERY(tNow);
-	return double(tNow - m_cLast - m_cFixAll)/double(m_cFreq);
+	return GetClockInfo().UseTSC;
 }
 
-#else
-
-using namespace std;
-using namespace chrono;
-auto _t = high_resolution_clock::now();
-auto _t1 = _t.time_since_epoch().count();
-auto _t2 = time_point_cast<nanoseconds>(_t).time_since_epoch().count();
-auto factor = double(nanoseconds::period::num) / nanoseconds::period::den * (double(_t2) / _t1);
-
 fcyStopWatch::fcyStopWatch()
 {
+	m_cFreq = GetFrequency(); // 初始化
 	Reset();
 }
 
@@ -64,22 +184,26 @@ fcyStopWatch::~fcyStopWatch()
 
 void fcyStopWatch::Pause()
 {
-	m_cFixStart = (uint64_t)TIME_NOW;
+	m_cFixStart = GetTimestamp();
 }
 
 void fcyStopWatch::Resume()
 {
-	m_cFixAll += (uint64_t)TIME_NOW - m_cFixStart;
+	m_cFixAll += GetTimestamp() - m_cFixStart;
 }
 
 void fcyStopWatch::Reset()
 {
 	m_cFixAll = 0;
-	m_cLast = (uint64_t)TIME_NOW;
+	m_cLast = GetTimestamp();
+}
+
+uint64_t fcyStopWatch::GetElapsedTicks()
+{
+	return GetTimestamp() - m_cLast - m_cFixAll;
 }
 
 double fcyStopWatch::GetElapsed()
 {
-	return double((uint64_t)TIME_NOW - m_cLast - m_cFixAll)*factor;
+	return TicksToSeconds(GetElapsedTicks());
 }
-#endif
@@ -10,20 +10,36 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief 高精度停表类
+/// @note  x86平台上CPU支持不变TSC时直接读取时间戳计数器，首次使用时对照steady_clock校准；
+///        否则Windows使用QueryPerformanceCounter，其余平台使用steady_clock。
+///        定义FCY_STOPWATCH_NO_TSC可禁用TSC模式。
 ////////////////////////////////////////////////////////////////////////////////
 class fcyStopWatch
 {
 private:
-	uint64_t m_cFreq;      ///< @brief CPU频率
+	uint64_t m_cFreq;      ///< @brief 计时频率
 	uint64_t m_cLast;      ///< @brief 上一次时间
 	uint64_t m_cFixStart;  ///< @brief 暂停时的时间修复参数
 	uint64_t m_cFixAll;    ///< @brief 暂停时的时间修复参数
+public:
+	/// @brief 获得当前时间戳
+	/// @note  单位为计时周期，与GetFrequency对应
+	static uint64_t GetTimestamp();
+	/// @brief 获得计时频率
+	/// @note  每秒的计时周期数
+	static uint64_t GetFrequency();
+	/// @brief 计时周期数转换到秒
+	static double TicksToSeconds(uint64_t Ticks);
+	/// @brief 是否使用TSC计时
+	static bool IsTSCEnabled();
 public:
 	void Pause();        ///< @brief 暂停
 	void Resume();       ///< @brief 继续
 	void Reset();        ///< @brief 归零
 	double GetElapsed(); ///< @brief 获得流逝时间
 	                      ///< @note  以秒为单位
+	uint64_t GetElapsedTicks(); ///< @brief 获得流逝时间
+	                            ///< @note  以计时周期为单位，可用TicksToSeconds转换
 public:
 	fcyStopWatch();
 	~fcyStopWatch();
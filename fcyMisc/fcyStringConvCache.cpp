@@ -0,0 +1,205 @@
+﻿#include "fcyStringConvCache.h"
+#include "fcyStringHelper.h"
+#include "fcyHash.h"
+
+#include <mutex>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t HashSource(string_view Source)
+{
+	return fcyHash::SuperFastHash((const uint8_t*)Source.data(), (uint32_t)Source.size());
+}
+
+fcyStringConvCache& fcyStringConvCache::GetInstance()
+{
+	static fcyStringConvCache s_Instance;
+	return s_Instance;
+}
+
+fcyStringConvCache::fcyStringConvCache(size_t ByteBudget)
+	: m_ShardBudget(ByteBudget / ShardCount)
+{
+}
+
+fcyStringConvCache::~fcyStringConvCache()
+{
+}
+
+size_t fcyStringConvCache::entryBytes(string_view Key, const wstring& Value)
+{
+	// 计入键、值与固定开销（槽位、哈希表节点、shared_ptr控制块）
+	return Key.size() + Value.size() * sizeof(wchar_t) + sizeof(Entry) + 64;
+}
+
+const fcyStringConvCache::Entry* fcyStringConvCache::findEntry(const Shard& S, uint32_t Hash, string_view Key)const
+{
+	auto tRange = S.Map.equal_range(Hash);
+	for(auto i = tRange.first; i != tRange.second; ++i)
+	{
+		const Entry& tEntry = S.Slots[i->second];
+		if(tEntry.Key == Key)
+			return &tEntry;
+	}
+	return nullptr;
+}
+
+void fcyStringConvCache::evictOne(Shard& S)
+{
+	// 调用方须持有写锁且分片非空
+	while(true)
+	{
+		if(S.Hand >= S.Slots.size())
+			S.Hand = 0;
+		uint32_t tSlot = (uint32_t)S.Hand++;
+		Entry& tEntry = S.Slots[tSlot];
+		if(!tEntry.Value)
+			continue;
+		if(tEntry.Referenced.exchange(false, memory_order_relaxed))
+			continue;
+
+		auto tRange = S.Map.equal_range(tEntry.Hash);
+		for(auto i = tRange.first; i != tRange.second; ++i)
+		{
+			if(i->second == tSlot)
+			{
+				S.Map.erase(i);
+				break;
+			}
+		}
+		S.Bytes -= tEntry.Bytes;
+		string().swap(tEntry.Key);
+		tEntry.Value.reset();
+		tEntry.Bytes = 0;
+		S.FreeSlots.push_back(tSlot);
+		S.Evictions.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+}
+
+void fcyStringConvCache::trimShard(Shard& S, size_t Budget)
+{
+	while(S.Bytes > Budget && !S.Map.empty())
+		evictOne(S);
+}
+
+fcyStringConvCache::WStringPtr fcyStringConvCache::MultiByteToWideChar_UTF8(string_view Source)
+{
+	uint32_t tHash = HashSource(Source);
+	Shard& tShard = m_Shards[tHash & (ShardCount - 1)];
+
+	{
+		shared_lock<shared_mutex> tLock(tShard.Lock);
+		const Entry* pEntry = findEntry(tShard, tHash, Source);
+		if(pEntry)
+		{
+			// 访问位已置位时不再写入缓存项
+			if(!pEntry->Referenced.load(memory_order_relaxed))
+				pEntry->Referenced.store(true, memory_order_relaxed);
+			tShard.Hits.fetch_add(1, memory_order_relaxed);
+			return pEntry->Value;
+		}
+	}
+
+	// 转换可能较慢，放在写锁之外以免阻塞同分片的命中；
+	// 多个线程同时未命中同一字符串时各自转换，插入时以先到者为准
+	tShard.Misses.fetch_add(1, memory_order_relaxed);
+	string tKey(Source);
+	WStringPtr tValue = make_shared<const wstring>(fcyStringHelper::MultiByteToWideChar_UTF8(tKey));
+	size_t tBytes = entryBytes(Source, *tValue);
+	size_t tBudget = m_ShardBudget.load(memory_order_relaxed);
+	if(tBytes > tBudget)
+	{
+		tShard.Bypasses.fetch_add(1, memory_order_relaxed);
+		return tValue;
+	}
+
+	unique_lock<shared_mutex> tLock(tShard.Lock);
+	const Entry* pEntry = findEntry(tShard, tHash, Source);
+	if(pEntry)
+		return pEntry->Value;
+
+	trimShard(tShard, tBudget - tBytes);
+
+	uint32_t tSlot;
+	if(!tShard.FreeSlots.empty())
+	{
+		tSlot = tShard.FreeSlots.back();
+		tShard.FreeSlots.pop_back();
+	}
+	else
+	{
+		tSlot = (uint32_t)tShard.Slots.size();
+		tShard.Slots.emplace_back();
+	}
+
+	Entry& tEntry = tShard.Slots[tSlot];
+	tEntry.Key = move(tKey);
+	tEntry.Value = tValue;
+	tEntry.Bytes = tBytes;
+	tEntry.Hash = tHash;
+	tEntry.Referenced.store(false, memory_order_relaxed);
+	tShard.Map.emplace(tHash, tSlot);
+	tShard.Bytes += tBytes;
+	return tValue;
+}
+
+void fcyStringConvCache::SetByteBudget(size_t ByteBudget)
+{
+	size_t tBudget = ByteBudget / ShardCount;
+	m_ShardBudget.store(tBudget, memory_order_relaxed);
+	for(Shard& s : m_Shards)
+	{
+		unique_lock<shared_mutex> tLock(s.Lock);
+		trimShard(s, tBudget);
+	}
+}
+
+size_t fcyStringConvCache::GetByteBudget()const
+{
+	return m_ShardBudget.load(memory_order_relaxed) * ShardCount;
+}
+
+fcyStringConvCache::Stats fcyStringConvCache::GetStats()const
+{
+	Stats tRet = {};
+	tRet.ByteBudget = GetByteBudget();
+	for(const Shard& s : m_Shards)
+	{
+		tRet.Hits += s.Hits.load(memory_order_relaxed);
+		tRet.Misses += s.Misses.load(memory_order_relaxed);
+		tRet.Evictions += s.Evictions.load(memory_order_relaxed);
+		tRet.Bypasses += s.Bypasses.load(memory_order_relaxed);
+
+		shared_lock<shared_mutex> tLock(s.Lock);
+		tRet.EntryCount += s.Map.size();
+		tRet.Bytes += s.Bytes;
+	}
+	return tRet;
+}
+
+void fcyStringConvCache::ResetStats()
+{
+	for(Shard& s : m_Shards)
+	{
+		s.Hits.store(0, memory_order_relaxed);
+		s.Misses.store(0, memory_order_relaxed);
+		s.Evictions.store(0, memory_order_relaxed);
+		s.Bypasses.store(0, memory_order_relaxed);
+	}
+}
+
+void fcyStringConvCache::Clear()
+{
+	for(Shard& s : m_Shards)
+	{
+		unique_lock<shared_mutex> tLock(s.Lock);
+		s.Map.clear();
+		s.Slots.clear();
+		s.FreeSlots.clear();
+		s.Hand = 0;
+		s.Bytes = 0;
+	}
+}
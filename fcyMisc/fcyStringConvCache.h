@@ -0,0 +1,120 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyStringConvCache.h
+/// @brief fancy字符串转换缓存
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <shared_mutex>
+#include <vector>
+
+/// @addtogroup fancy杂项
+/// @{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief UTF-8到宽字符串的转换缓存
+/// @note  以源字符串的fcyHash为键，命中时直接返回之前转换好的共享缓冲区。
+///        缓存按字节预算限制大小，超出时以CLOCK算法淘汰最近未被访问的项。
+///        返回的缓冲区不可修改，被淘汰后仍由持有者保持有效。
+///        线程安全。命中时持有分片读锁并复制一次shared_ptr；访问位只在未置位时写入，
+///        同一项被反复命中时不再改写缓存项本身。
+////////////////////////////////////////////////////////////////////////////////
+class fcyStringConvCache
+{
+public:
+	typedef std::shared_ptr<const std::wstring> WStringPtr;
+
+	/// @brief 统计信息
+	struct Stats
+	{
+		uint64_t Hits;       ///< @brief 命中次数
+		uint64_t Misses;     ///< @brief 未命中次数
+		uint64_t Evictions;  ///< @brief 淘汰项数
+		uint64_t Bypasses;   ///< @brief 因超出分片预算而未缓存的次数
+		size_t EntryCount;   ///< @brief 当前项数
+		size_t Bytes;        ///< @brief 当前占用字节数（估算）
+		size_t ByteBudget;   ///< @brief 字节预算
+	};
+private:
+	static const uint32_t ShardCount = 16;  ///< @brief 分片数量，按哈希低位选择分片
+
+	/// @brief 缓存项
+	struct Entry
+	{
+		std::string Key;                  ///< @brief 源字符串，为空且Value为空时表示空闲
+		WStringPtr Value;                 ///< @brief 转换结果
+		size_t Bytes;                     ///< @brief 占用字节数
+		uint32_t Hash;                    ///< @brief 源字符串哈希
+		mutable std::atomic<bool> Referenced; ///< @brief CLOCK访问位
+
+		Entry()
+			: Bytes(0), Hash(0), Referenced(false) {}
+	};
+
+	/// @brief 分片
+	struct Shard
+	{
+		mutable std::shared_mutex Lock;
+		std::unordered_multimap<uint32_t, uint32_t> Map;  ///< @brief 哈希到槽位
+		std::deque<Entry> Slots;          ///< @brief 槽位，Entry含原子量不可移动，deque追加时不搬移已有槽位
+		std::vector<uint32_t> FreeSlots;  ///< @brief 空闲槽位
+		size_t Hand;                      ///< @brief CLOCK指针
+		size_t Bytes;                     ///< @brief 占用字节数
+		std::atomic<uint64_t> Hits;
+		std::atomic<uint64_t> Misses;
+		std::atomic<uint64_t> Evictions;
+		std::atomic<uint64_t> Bypasses;
+
+		Shard()
+			: Hand(0), Bytes(0), Hits(0), Misses(0), Evictions(0), Bypasses(0) {}
+	};
+private:
+	Shard m_Shards[ShardCount];            ///< @brief 分片
+	std::atomic<size_t> m_ShardBudget;     ///< @brief 每分片字节预算
+private:
+	static size_t entryBytes(std::string_view Key, const std::wstring& Value);
+	const Entry* findEntry(const Shard& S, uint32_t Hash, std::string_view Key)const;
+	void evictOne(Shard& S);
+	void trimShard(Shard& S, size_t Budget);
+public:
+	/// @brief 获得全局实例
+	static fcyStringConvCache& GetInstance();
+
+	/// @brief     获得UTF-8字符串的宽字符转换结果
+	/// @note      结果与fcyStringHelper::MultiByteToWideChar_UTF8相同
+	/// @param[in] Source UTF-8字符串
+	/// @return    共享的转换结果，不为空
+	WStringPtr MultiByteToWideChar_UTF8(std::string_view Source);
+
+	/// @brief     设置字节预算
+	/// @note      缩小预算会立即淘汰多余的项
+	/// @param[in] ByteBudget 字节预算
+	void SetByteBudget(size_t ByteBudget);
+
+	/// @brief 获得字节预算
+	size_t GetByteBudget()const;
+
+	/// @brief 获得统计信息
+	Stats GetStats()const;
+
+	/// @brief 清零命中/未命中/淘汰计数
+	void ResetStats();
+
+	/// @brief 清空缓存
+	/// @note  之前返回的缓冲区仍然有效
+	void Clear();
+public:
+	/// @brief     构造
+	/// @param[in] ByteBudget 字节预算，默认4MB
+	fcyStringConvCache(size_t ByteBudget = 4 * 1024 * 1024);
+	~fcyStringConvCache();
+private:
+	fcyStringConvCache(const fcyStringConvCache&) = delete;
+	fcyStringConvCache& operator=(const fcyStringConvCache&) = delete;
+};
+/// @}
@@ -1,9 +1,18 @@
 ﻿#include "fcyStringHelper.h"
 
 #include <algorithm>
+#include <cstring>
 #include <locale>
 #include <codecvt>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FCY_STRING_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define FCY_STRING_NEON
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -50,10 +59,35 @@ uint32_t fcyStringHelper::StringSplit(const wstring& Source, const wstring& Spli
 	return ret.size();
 }
 
+uint32_t fcyStringHelper::StringSplitView(string_view Source, string_view SplitStr, bool AutoTrim, vector<string_view>& Out)
+{
+	Out.clear();
+	if(SplitStr.empty())
+	{
+		if(!(AutoTrim&&Source.empty()))Out.push_back(Source);
+		return (uint32_t)Out.size();
+	}
+
+	size_t last = 0;
+	size_t pos = Source.find(SplitStr);
+	while(pos != string_view::npos)
+	{
+		string_view tstr = Source.substr(last, pos-last);
+		if(!(AutoTrim&&tstr.empty()))Out.push_back(tstr);
+
+		last = pos + SplitStr.length();
+		pos = Source.find(SplitStr, last);
+	}
+	string_view tstr = Source.substr(last);
+	if(!(AutoTrim&&tstr.empty()))Out.push_back(tstr);
+
+	return (uint32_t)Out.size();
+}
+
 string fcyStringHelper::ToLower(const string& Source)
 {
 	string tRet = Source;
-	transform(tRet.begin(), tRet.end(), tRet.begin(), ::tolower);
+	ToLowerInPlace(tRet);
 	
 	return tRet;
 }
@@ -143,29 +177,181 @@ wstring fcyStringHelper::TrimRight(const wstring &Org)
 
 wstring fcyStringHelper::Trim(const wstring &Org)
 {
-	return TrimLeft(TrimRight(Org));
+	auto pBegin = find_if_not(Org.begin(), Org.end(), iswspace);
+	auto pEnd = find_if_not(Org.rbegin(), wstring::const_reverse_iterator(pBegin), iswspace).base();
+	return wstring(pBegin, pEnd);
 }
 
 string fcyStringHelper::TrimLeft(const string &Org)
 { 
-	string tRet = Org;
-	string::const_iterator p = find_if_not(tRet.begin(), tRet.end(), ::isspace); 
-	tRet.erase(tRet.begin(), p); 
-	return tRet;
+	return string(TrimLeftView(Org));
 }
 
 string fcyStringHelper::TrimRight(const string &Org)
 {
-	string tRet = Org;
-	string::const_reverse_iterator p = find_if_not(tRet.rbegin(), tRet.rend(), ::isspace); 
-	tRet.erase(p.base(), tRet.end()); 
-	return tRet; 
+	return string(TrimRightView(Org));
 }
 
 string fcyStringHelper::Trim(const string &Org)
 {
-	return TrimLeft(TrimRight(Org));
+	return string(TrimView(Org));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+// 与C locale下的isspace一致
+static inline bool IsAsciiSpace(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// 按字节读取8字节，避免未对齐访问
+static inline uint64_t LoadWord(const char* p)
+{
+	uint64_t tRet;
+	memcpy(&tRet, p, sizeof(tRet));
+	return tRet;
+}
+
+// 8字节内的ASCII大写字母转小写（SWAR）
+static inline uint64_t LowerWord(uint64_t x)
+{
+	const uint64_t tHigh = 0x8080808080808080ULL;
+	uint64_t tLow7 = x & ~tHigh;
+	uint64_t tGtZ = tLow7 + 0x2525252525252525ULL;  // 0x80 - 'Z' - 1
+	uint64_t tGeA = tLow7 + 0x3F3F3F3F3F3F3F3FULL;  // 0x80 - 'A'
+	uint64_t tUpper = ~x & (tGeA ^ tGtZ) & tHigh;
+	return x | (tUpper >> 2);
+}
+
+static inline char LowerChar(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? (char)(c + 0x20) : c;
+}
+
+string_view fcyStringHelper::TrimLeftView(string_view Org)
+{
+	size_t i = 0;
+	while (i < Org.size() && IsAsciiSpace(Org[i]))
+		++i;
+	return Org.substr(i);
+}
+
+string_view fcyStringHelper::TrimRightView(string_view Org)
+{
+	size_t i = Org.size();
+	while (i > 0 && IsAsciiSpace(Org[i - 1]))
+		--i;
+	return Org.substr(0, i);
 }
+
+string_view fcyStringHelper::TrimView(string_view Org)
+{
+	return TrimRightView(TrimLeftView(Org));
+}
+
+void fcyStringHelper::ToLowerInPlace(char* pStr, size_t Len)
+{
+	size_t i = 0;
+
+#if defined(FCY_STRING_SSE2)
+	// 平移使'A'对齐到-128，从而用一次有符号比较判断区间
+	const __m128i tShift = _mm_set1_epi8((char)(0x80 - 'A'));
+	const __m128i tBound = _mm_set1_epi8((char)(-128 + 26));
+	const __m128i tBit = _mm_set1_epi8(0x20);
+	for (; Len - i >= 16; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(pStr + i));
+		__m128i tUpper = _mm_cmplt_epi8(_mm_add_epi8(v, tShift), tBound);
+		_mm_storeu_si128((__m128i*)(pStr + i), _mm_or_si128(v, _mm_and_si128(tUpper, tBit)));
+	}
+#elif defined(FCY_STRING_NEON)
+	const uint8x16_t tA = vdupq_n_u8('A');
+	const uint8x16_t tRange = vdupq_n_u8(25);
+	const uint8x16_t tBit = vdupq_n_u8(0x20);
+	for (; Len - i >= 16; i += 16)
+	{
+		uint8x16_t v = vld1q_u8((const uint8_t*)(pStr + i));
+		uint8x16_t tUpper = vcleq_u8(vsubq_u8(v, tA), tRange);
+		vst1q_u8((uint8_t*)(pStr + i), vorrq_u8(v, vandq_u8(tUpper, tBit)));
+	}
+#endif
+
+	for (; Len - i >= 8; i += 8)
+	{
+		uint64_t w = LowerWord(LoadWord(pStr + i));
+		memcpy(pStr + i, &w, sizeof(w));
+	}
+	for (; i < Len; ++i)
+		pStr[i] = LowerChar(pStr[i]);
+}
+
+void fcyStringHelper::ToLowerInPlace(string& Str)
+{
+	if (!Str.empty())
+		ToLowerInPlace(&Str[0], Str.size());
+}
+
+int fcyStringHelper::CompareNoCase(string_view Left, string_view Right)
+{
+	const size_t tLen = min(Left.size(), Right.size());
+	const char* pL = Left.data();
+	const char* pR = Right.data();
+	size_t i = 0;
+
+	// 快速跳过相同的部分
+	while (tLen - i >= 8 && LowerWord(LoadWord(pL + i)) == LowerWord(LoadWord(pR + i)))
+		i += 8;
+
+	for (; i < tLen; ++i)
+	{
+		uint8_t a = (uint8_t)LowerChar(pL[i]);
+		uint8_t b = (uint8_t)LowerChar(pR[i]);
+		if (a != b)
+			return a < b ? -1 : 1;
+	}
+
+	if (Left.size() == Right.size())
+		return 0;
+	return Left.size() < Right.size() ? -1 : 1;
+}
+
+bool fcyStringHelper::EqualsNoCase(string_view Left, string_view Right)
+{
+	return Left.size() == Right.size() && CompareNoCase(Left, Right) == 0;
+}
+
+bool fcyStringHelper::EndsWithNoCase(string_view Str, string_view Suffix)
+{
+	return Str.size() >= Suffix.size() && EqualsNoCase(Str.substr(Str.size() - Suffix.size()), Suffix);
+}
+
+uint32_t fcyStringHelper::HashNoCase(string_view Str)
+{
+	const uint64_t tMul = 0x9E3779B97F4A7C15ULL;
+	const char* p = Str.data();
+	size_t tLen = Str.size();
+	uint64_t h = tLen * tMul;
+
+	for (; tLen >= 8; tLen -= 8, p += 8)
+	{
+		h ^= LowerWord(LoadWord(p));
+		h *= tMul;
+		h ^= h >> 29;
+	}
+	if (tLen > 0)
+	{
+		uint64_t w = 0;
+		memcpy(&w, p, tLen);
+		h ^= LowerWord(w);
+		h *= tMul;
+		h ^= h >> 29;
+	}
+
+	h *= tMul;
+	return (uint32_t)(h ^ (h >> 32));
+}
+
 /*
 wstring fcyStringHelper::MultiByteToWideChar(const string& Org, uint32_t CodePage)
 {
@@ -189,7 +375,8 @@ string fcyStringHelper::WideCharToMultiByte(const wstring& Org, uint32_t CodePag
 }
 */
 
-wstring_convert<codecvt_utf8<wchar_t>> cv;
+// wstring_convert带有内部状态，每线程一个实例以便并发转换
+thread_local wstring_convert<codecvt_utf8<wchar_t>> cv;
 
 wstring fcyStringHelper::MultiByteToWideChar_UTF8(const string& Org)
 {
@@ -218,3 +405,236 @@ string fcyStringHelper::WideCharToMultiByte_UTF8(const wstring& Org)
 	}
 	return ret;
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+// 统计UTF-8后续字节（10xxxxxx）的数量
+static size_t CountUTF8Continuation(const uint8_t* p, size_t Len)
+{
+	size_t tCount = 0;
+	size_t i = 0;
+
+#if defined(FCY_STRING_SSE2)
+	// 后续字节作为有符号数时小于-64
+	const __m128i tBound = _mm_set1_epi8(-64);
+	const __m128i tZero = _mm_setzero_si128();
+	while (Len - i >= 16)
+	{
+		// 8位累加器最多累加255次
+		size_t tBlocks = min<size_t>((Len - i) / 16, 255);
+		__m128i tAcc = _mm_setzero_si128();
+		for (size_t j = 0; j < tBlocks; ++j, i += 16)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+			tAcc = _mm_sub_epi8(tAcc, _mm_cmplt_epi8(v, tBound));
+		}
+		__m128i tSum = _mm_sad_epu8(tAcc, tZero);
+		tCount += (size_t)_mm_cvtsi128_si32(tSum) + (size_t)_mm_cvtsi128_si32(_mm_srli_si128(tSum, 8));
+	}
+#elif defined(FCY_STRING_NEON)
+	const int8x16_t tBound = vdupq_n_s8(-64);
+	while (Len - i >= 16)
+	{
+		size_t tBlocks = min<size_t>((Len - i) / 16, 255);
+		uint8x16_t tAcc = vdupq_n_u8(0);
+		for (size_t j = 0; j < tBlocks; ++j, i += 16)
+		{
+			int8x16_t v = vreinterpretq_s8_u8(vld1q_u8(p + i));
+			tAcc = vsubq_u8(tAcc, vcltq_s8(v, tBound));
+		}
+		tCount += vaddlvq_u8(tAcc);
+	}
+#endif
+
+	for (; i < Len; ++i)
+	{
+		if ((p[i] & 0xC0) == 0x80)
+			++tCount;
+	}
+	return tCount;
+}
+
+size_t fcyStringHelper::UTF8Length(string_view Str)
+{
+	return Str.size() - CountUTF8Continuation((const uint8_t*)Str.data(), Str.size());
+}
+
+size_t fcyStringHelper::UTF8Offset(string_view Str, size_t Index)
+{
+	const uint8_t* p = (const uint8_t*)Str.data();
+	const size_t tLen = Str.size();
+	size_t i = 0;
+
+	// 整块跳过不含目标码点的数据
+	while (tLen - i >= 64)
+	{
+		size_t tLeads = 64 - CountUTF8Continuation(p + i, 64);
+		if (tLeads > Index)
+			break;
+		Index -= tLeads;
+		i += 64;
+	}
+
+	for (; i < tLen; ++i)
+	{
+		if ((p[i] & 0xC0) != 0x80)
+		{
+			if (Index == 0)
+				return i;
+			--Index;
+		}
+	}
+	return tLen;
+}
+
+bool fcyStringHelper::UTF8IsSpace(char32_t Code)
+{
+	if (Code < 0x80)
+		return Code == ' ' || (Code >= 0x09 && Code <= 0x0D);
+	switch (Code)
+	{
+	case 0x0085: case 0x00A0: case 0x1680:
+	case 0x2028: case 0x2029: case 0x202F: case 0x205F: case 0x3000:
+		return true;
+	default:
+		return Code >= 0x2000 && Code <= 0x200A;
+	}
+}
+
+string_view fcyStringHelper::UTF8TrimLeft(string_view Org)
+{
+	const char* pBegin = Org.data();
+	const char* pEnd = pBegin + Org.size();
+	const char* p = pBegin;
+	while (p < pEnd)
+	{
+		char32_t c = 0;
+		size_t n = UTF8Decode(p, pEnd, c);
+		if (!UTF8IsSpace(c))
+			break;
+		p += n;
+	}
+	return Org.substr((size_t)(p - pBegin));
+}
+
+string_view fcyStringHelper::UTF8TrimRight(string_view Org)
+{
+	const char* pBegin = Org.data();
+	const char* pEnd = pBegin + Org.size();
+	while (pEnd > pBegin)
+	{
+		// 回退到最后一个码点的首字节
+		const char* p = pEnd - 1;
+		while (p > pBegin && pEnd - p < 4 && ((uint8_t)*p & 0xC0) == 0x80)
+			--p;
+		char32_t c = 0;
+		size_t n = UTF8Decode(p, pEnd, c);
+		// 非法序列只消耗一个字节，此时视为非空白
+		if (p + n != pEnd || !UTF8IsSpace(c))
+			break;
+		pEnd = p;
+	}
+	return Org.substr(0, (size_t)(pEnd - pBegin));
+}
+
+string_view fcyStringHelper::UTF8Trim(string_view Org)
+{
+	return UTF8TrimRight(UTF8TrimLeft(Org));
+}
+
+char32_t fcyStringHelper::UTF8FoldCase(char32_t Code)
+{
+	if (Code < 0x80)
+		return (Code >= 'A' && Code <= 'Z') ? Code + 0x20 : Code;
+	if (Code < 0xC0)
+		return Code == 0xB5 ? 0x3BC : Code;  // MICRO SIGN -> GREEK SMALL LETTER MU
+	if (Code <= 0xDE)
+		return Code == 0xD7 ? Code : Code + 0x20;
+	if (Code < 0x100 || Code > 0x17F)
+		return Code;
+
+	// 拉丁文扩展A区
+	if (Code == 0x130 || Code == 0x131 || Code == 0x138 || Code == 0x149)
+		return Code;  // 无简单折叠或依赖语言
+	if (Code == 0x178)
+		return 0xFF;
+	if (Code == 0x17F)
+		return 's';
+	if ((Code >= 0x139 && Code <= 0x148) || (Code >= 0x179 && Code <= 0x17E))
+		return (Code & 1) ? Code + 1 : Code;
+	return (Code & 1) ? Code : Code + 1;
+}
+
+size_t fcyStringHelper::UTF8FoldCaseInPlace(char* pStr, size_t Len)
+{
+	const char* pEnd = pStr + Len;
+	const char* pRead = pStr;
+	char* pWrite = pStr;
+
+	while (pRead < pEnd)
+	{
+		uint8_t b = (uint8_t)*pRead;
+		if (b < 0x80)
+		{
+			*pWrite++ = (b >= 'A' && b <= 'Z') ? (char)(b + 0x20) : (char)b;
+			++pRead;
+			continue;
+		}
+
+		// 非ASCII只消耗一个字节时为非法序列，原样保留
+		char32_t c = 0;
+		size_t n = UTF8Decode(pRead, pEnd, c);
+		char32_t f = (n == 1) ? c : UTF8FoldCase(c);
+		if (f == c)
+		{
+			if (pWrite != pRead)
+				memmove(pWrite, pRead, n);
+			pWrite += n;
+		}
+		else if (f < 0x80)
+			*pWrite++ = (char)f;
+		else
+		{
+			// 此处的折叠结果均为两字节编码
+			pWrite[0] = (char)(0xC0 | (f >> 6));
+			pWrite[1] = (char)(0x80 | (f & 0x3F));
+			pWrite += 2;
+		}
+		pRead += n;
+	}
+	return (size_t)(pWrite - pStr);
+}
+
+void fcyStringHelper::UTF8FoldCaseInPlace(string& Str)
+{
+	if (Str.empty())
+		return;
+	Str.resize(UTF8FoldCaseInPlace(&Str[0], Str.size()));
+}
+
+bool fcyStringHelper::UTF8EqualsNoCase(string_view Left, string_view Right)
+{
+	const char* pL = Left.data();
+	const char* pLEnd = pL + Left.size();
+	const char* pR = Right.data();
+	const char* pREnd = pR + Right.size();
+
+	while (pL < pLEnd && pR < pREnd)
+	{
+		uint8_t a = (uint8_t)*pL, b = (uint8_t)*pR;
+		if ((a | b) < 0x80)
+		{
+			if (a != b && UTF8FoldCase(a) != UTF8FoldCase(b))
+				return false;
+			++pL; ++pR;
+			continue;
+		}
+
+		char32_t ca = 0, cb = 0;
+		pL += UTF8Decode(pL, pLEnd, ca);
+		pR += UTF8Decode(pR, pREnd, cb);
+		if (ca != cb && UTF8FoldCase(ca) != UTF8FoldCase(cb))
+			return false;
+	}
+	return pL == pLEnd && pR == pREnd;
+}
@@ -6,6 +6,9 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <iterator>
+#include <cstdint>
 
 /// @addtogroup fancy杂项
 /// @brief 未分类对象
@@ -30,6 +33,15 @@ namespace fcyStringHelper
 	/// @return     被分割的数量
 	uint32_t StringSplit(const std::wstring& Source, const std::wstring& SplitStr, bool AutoTrim, std::vector<std::wstring>& Out);
 	
+	/// @brief      字符串分割，不复制
+	/// @note       与StringSplit语义相同，输出为源字符串的子视图
+	/// @param[in]  Source   源字符串
+	/// @param[in]  SplitStr 用于分割的字符串
+	/// @param[in]  AutoTrim 自动剔除空白的分割项
+	/// @param[out] Out      输出的列表
+	/// @return     被分割的数量
+	uint32_t StringSplitView(std::string_view Source, std::string_view SplitStr, bool AutoTrim, std::vector<std::string_view>& Out);
+
 	/// @brief     字符串到小写
 	/// @param[in] Source   源字符串
 	/// @return    被转换的字符串
@@ -98,6 +110,57 @@ namespace fcyStringHelper
 	/// @param[in] Org 原始字符串
 	std::string Trim(const std::string &Org);
 
+	/// @brief     剔除左侧ASCII空白字符，不复制
+	/// @param[in] Org 原始字符串
+	/// @return    原始字符串的子视图
+	std::string_view TrimLeftView(std::string_view Org);
+
+	/// @brief     剔除右侧ASCII空白字符，不复制
+	/// @param[in] Org 原始字符串
+	/// @return    原始字符串的子视图
+	std::string_view TrimRightView(std::string_view Org);
+
+	/// @brief     剔除两侧ASCII空白字符，不复制
+	/// @param[in] Org 原始字符串
+	/// @return    原始字符串的子视图
+	std::string_view TrimView(std::string_view Org);
+
+	/// @brief     原地转换ASCII字符到小写
+	/// @note      有SIMD加速，非ASCII字节原样保留
+	/// @param[in] pStr 字符串数据
+	/// @param[in] Len  字节长度
+	void ToLowerInPlace(char* pStr, size_t Len);
+
+	/// @brief     原地转换ASCII字符到小写
+	/// @param[in] Str 字符串
+	void ToLowerInPlace(std::string& Str);
+
+	/// @brief     忽略ASCII大小写比较，不生成小写副本
+	/// @return    小于0、等于0、大于0分别表示Left小于、等于、大于Right
+	int CompareNoCase(std::string_view Left, std::string_view Right);
+
+	/// @brief 忽略ASCII大小写判断相等
+	bool EqualsNoCase(std::string_view Left, std::string_view Right);
+
+	/// @brief 忽略ASCII大小写判断后缀，可用于扩展名匹配
+	bool EndsWithNoCase(std::string_view Str, std::string_view Suffix);
+
+	/// @brief     忽略ASCII大小写的哈希值
+	/// @note      仅大小写不同的字符串具有相同哈希值
+	uint32_t HashNoCase(std::string_view Str);
+
+	/// @brief 忽略大小写的哈希函数对象，用于无序容器
+	struct NoCaseHash
+	{
+		size_t operator()(std::string_view Str)const { return HashNoCase(Str); }
+	};
+
+	/// @brief 忽略大小写的相等函数对象，用于无序容器
+	struct NoCaseEqual
+	{
+		bool operator()(std::string_view Left, std::string_view Right)const { return EqualsNoCase(Left, Right); }
+	};
+
 	/// @brief     string到wstring
 	/// @param[in] Org 原始字符串
 	/// @param[in] CodePage 代码页，具体查阅MSDN
@@ -113,5 +176,188 @@ namespace fcyStringHelper
 
 	std::wstring MultiByteToWideChar_UTF8(const std::string& Org);
 	std::string WideCharToMultiByte_UTF8(const std::wstring& Org);
+
+	/// @brief      解码一个UTF-8字符
+	/// @note       非法序列（截断、过长编码、代理区、超出U+10FFFF）解码为U+FFFD并只消耗一个字节
+	/// @param[in]  pBegin 当前位置
+	/// @param[in]  pEnd   结束位置
+	/// @param[out] Out    解码出的码点
+	/// @return     消耗的字节数，pBegin>=pEnd时返回0
+	inline size_t UTF8Decode(const char* pBegin, const char* pEnd, char32_t& Out)
+	{
+		if (pBegin >= pEnd)
+			return 0;
+
+		const uint8_t* p = (const uint8_t*)pBegin;
+		const size_t tAvail = (size_t)(pEnd - pBegin);
+		const uint8_t c = p[0];
+
+		if (c < 0x80)
+		{
+			Out = c;
+			return 1;
+		}
+
+		size_t tLen;
+		char32_t tCode;
+		char32_t tMin;
+		if ((c & 0xE0) == 0xC0)
+		{
+			tLen = 2; tCode = c & 0x1F; tMin = 0x80;
+		}
+		else if ((c & 0xF0) == 0xE0)
+		{
+			tLen = 3; tCode = c & 0x0F; tMin = 0x800;
+		}
+		else if ((c & 0xF8) == 0xF0)
+		{
+			tLen = 4; tCode = c & 0x07; tMin = 0x10000;
+		}
+		else
+		{
+			Out = 0xFFFD;
+			return 1;
+		}
+
+		if (tAvail < tLen)
+		{
+			Out = 0xFFFD;
+			return 1;
+		}
+		for (size_t i = 1; i < tLen; ++i)
+		{
+			if ((p[i] & 0xC0) != 0x80)
+			{
+				Out = 0xFFFD;
+				return 1;
+			}
+			tCode = (tCode << 6) | (p[i] & 0x3F);
+		}
+		if (tCode < tMin || tCode > 0x10FFFF || (tCode >= 0xD800 && tCode <= 0xDFFF))
+		{
+			Out = 0xFFFD;
+			return 1;
+		}
+
+		Out = tCode;
+		return tLen;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief UTF-8码点迭代器
+	/// @note  直接在原始字节上迭代，不分配内存
+	////////////////////////////////////////////////////////////////////////////////
+	class UTF8Iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef char32_t value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const char32_t* pointer;
+		typedef const char32_t& reference;
+	private:
+		const char* m_Cur;  ///< @brief 当前位置
+		const char* m_End;  ///< @brief 结束位置
+		char32_t m_Char;    ///< @brief 当前码点
+		size_t m_Len;       ///< @brief 当前码点的字节数
+	public:
+		/// @brief 当前码点
+		reference operator*()const { return m_Char; }
+		/// @brief 当前码点在原始数据中的位置
+		const char* GetPtr()const { return m_Cur; }
+		/// @brief 当前码点的字节数
+		size_t GetByteLength()const { return m_Len; }
+
+		UTF8Iterator& operator++()
+		{
+			m_Cur += m_Len;
+			m_Len = UTF8Decode(m_Cur, m_End, m_Char);
+			return *this;
+		}
+		UTF8Iterator operator++(int)
+		{
+			UTF8Iterator tRet = *this;
+			++(*this);
+			return tRet;
+		}
+		bool operator==(const UTF8Iterator& Right)const { return m_Cur == Right.m_Cur; }
+		bool operator!=(const UTF8Iterator& Right)const { return m_Cur != Right.m_Cur; }
+	public:
+		UTF8Iterator()
+			: m_Cur(nullptr), m_End(nullptr), m_Char(0), m_Len(0) {}
+		UTF8Iterator(const char* pCur, const char* pEnd)
+			: m_Cur(pCur), m_End(pEnd), m_Char(0)
+		{
+			m_Len = UTF8Decode(m_Cur, m_End, m_Char);
+		}
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief UTF-8码点区间
+	/// @note  用于range-for：for(char32_t c : UTF8Range(str))
+	////////////////////////////////////////////////////////////////////////////////
+	class UTF8Range
+	{
+	private:
+		std::string_view m_Str;
+	public:
+		UTF8Iterator begin()const { return UTF8Iterator(m_Str.data(), m_Str.data() + m_Str.size()); }
+		UTF8Iterator end()const { return UTF8Iterator(m_Str.data() + m_Str.size(), m_Str.data() + m_Str.size()); }
+	public:
+		explicit UTF8Range(std::string_view Str)
+			: m_Str(Str) {}
+	};
+
+	/// @brief     计算UTF-8字符串的码点数量
+	/// @note      统计非后续字节的数量，对合法UTF-8与迭代结果一致；有SIMD加速
+	/// @param[in] Str UTF-8字符串
+	/// @return    码点数量
+	size_t UTF8Length(std::string_view Str);
+
+	/// @brief     获得第N个码点的字节偏移
+	/// @param[in] Str   UTF-8字符串
+	/// @param[in] Index 码点下标
+	/// @return    字节偏移，超出范围时返回Str.size()
+	size_t UTF8Offset(std::string_view Str, size_t Index);
+
+	/// @brief     判断码点是否为Unicode空白字符
+	/// @param[in] Code 码点
+	bool UTF8IsSpace(char32_t Code);
+
+	/// @brief     剔除左侧Unicode空白字符，不复制
+	/// @param[in] Org UTF-8字符串
+	/// @return    原始字符串的子视图
+	std::string_view UTF8TrimLeft(std::string_view Org);
+
+	/// @brief     剔除右侧Unicode空白字符，不复制
+	/// @param[in] Org UTF-8字符串
+	/// @return    原始字符串的子视图
+	std::string_view UTF8TrimRight(std::string_view Org);
+
+	/// @brief     剔除两侧Unicode空白字符，不复制
+	/// @param[in] Org UTF-8字符串
+	/// @return    原始字符串的子视图
+	std::string_view UTF8Trim(std::string_view Org);
+
+	/// @brief     码点简单大小写折叠
+	/// @note      仅处理ASCII、Latin-1补充和拉丁文扩展A区，其余码点原样返回
+	/// @param[in] Code 码点
+	/// @return    折叠后的码点
+	char32_t UTF8FoldCase(char32_t Code);
+
+	/// @brief     原地大小写折叠
+	/// @note      折叠后的编码不会比原编码更长，非法字节原样保留
+	/// @param[in] pStr 字符串数据
+	/// @param[in] Len  字节长度
+	/// @return    折叠后的字节长度
+	size_t UTF8FoldCaseInPlace(char* pStr, size_t Len);
+
+	/// @brief     原地大小写折叠
+	/// @param[in] Str UTF-8字符串
+	void UTF8FoldCaseInPlace(std::string& Str);
+
+	/// @brief     忽略大小写比较两个UTF-8字符串是否相等
+	/// @note      使用UTF8FoldCase的折叠规则，不分配内存
+	bool UTF8EqualsNoCase(std::string_view Left, std::string_view Right);
 }
 /// @}
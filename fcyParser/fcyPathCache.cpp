@@ -0,0 +1,120 @@
+﻿#include "fcyPathCache.h"
+#include "fcyPathParser.h"
+
+#include "../fcyMisc/fcyHash.h"
+#include <mutex>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t HashRawPath(string_view RawPath)
+{
+	return fcyHash::SuperFastHash((const uint8_t*)RawPath.data(), (uint32_t)RawPath.size());
+}
+
+fcyPathCache::fcyPathCache()
+{
+}
+
+fcyPathCache::~fcyPathCache()
+{
+}
+
+uint32_t fcyPathCache::internCanonical(string&& Canonical)
+{
+	unique_lock<shared_mutex> tLock(m_CanonicalLock);
+
+	auto i = m_CanonicalID.find(Canonical);
+	if(i != m_CanonicalID.end())
+		return i->second;
+
+	uint32_t tID = (uint32_t)m_Canonical.size();
+	m_Canonical.push_back(move(Canonical));
+	m_CanonicalID.emplace(m_Canonical.back(), tID);
+	return tID;
+}
+
+uint32_t fcyPathCache::GetID(string_view RawPath)
+{
+	uint32_t tHash = HashRawPath(RawPath);
+	Shard& tShard = m_Shards[tHash & (ShardCount - 1)];
+
+	{
+		shared_lock<shared_mutex> tLock(tShard.Lock);
+		auto tRange = tShard.Map.equal_range(tHash);
+		for(auto i = tRange.first; i != tRange.second; ++i)
+		{
+			if(i->second.Raw == RawPath)
+				return i->second.ID;
+		}
+	}
+
+	// 在锁外规范化，并发的相同请求最多重复计算一次
+	uint32_t tID = internCanonical(fcyPathParser::Normalize(RawPath));
+
+	unique_lock<shared_mutex> tLock(tShard.Lock);
+	auto tRange = tShard.Map.equal_range(tHash);
+	for(auto i = tRange.first; i != tRange.second; ++i)
+	{
+		if(i->second.Raw == RawPath)
+			return i->second.ID;
+	}
+	tShard.Map.emplace(tHash, RawEntry { string(RawPath), tID });
+	return tID;
+}
+
+uint32_t fcyPathCache::FindID(string_view RawPath)const
+{
+	uint32_t tHash = HashRawPath(RawPath);
+	const Shard& tShard = m_Shards[tHash & (ShardCount - 1)];
+
+	shared_lock<shared_mutex> tLock(tShard.Lock);
+	auto tRange = tShard.Map.equal_range(tHash);
+	for(auto i = tRange.first; i != tRange.second; ++i)
+	{
+		if(i->second.Raw == RawPath)
+			return i->second.ID;
+	}
+	return InvalidID;
+}
+
+const string& fcyPathCache::GetCanonicalPath(uint32_t ID)const
+{
+	static const string s_Empty;
+
+	shared_lock<shared_mutex> tLock(m_CanonicalLock);
+	if(ID >= m_Canonical.size())
+		return s_Empty;
+	return m_Canonical[ID];
+}
+
+uint32_t fcyPathCache::GetCanonicalCount()const
+{
+	shared_lock<shared_mutex> tLock(m_CanonicalLock);
+	return (uint32_t)m_Canonical.size();
+}
+
+uint32_t fcyPathCache::GetRawCount()const
+{
+	size_t tRet = 0;
+	for(auto& tShard : m_Shards)
+	{
+		shared_lock<shared_mutex> tLock(tShard.Lock);
+		tRet += tShard.Map.size();
+	}
+	return (uint32_t)tRet;
+}
+
+void fcyPathCache::Clear()
+{
+	for(auto& tShard : m_Shards)
+	{
+		unique_lock<shared_mutex> tLock(tShard.Lock);
+		tShard.Map.clear();
+	}
+
+	unique_lock<shared_mutex> tLock(m_CanonicalLock);
+	m_CanonicalID.clear();
+	m_Canonical.clear();
+}
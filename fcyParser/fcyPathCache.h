@@ -0,0 +1,83 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyPathCache.h
+/// @brief fcy规范路径缓存
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+
+/// @addtogroup fancy库解析辅助
+/// @{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 规范路径缓存
+/// @note  以原始路径的fcyHash为键，每个不同的原始路径只规范化一次，
+///        规范化结果被驻留为整数ID，相同的规范路径总是得到相同的ID。
+///        线程安全，查询命中时只获取分片读锁。
+////////////////////////////////////////////////////////////////////////////////
+class fcyPathCache
+{
+public:
+	static const uint32_t InvalidID = 0xFFFFFFFFu; ///< @brief 无效ID
+private:
+	static const uint32_t ShardCount = 16;         ///< @brief 分片数量，须为2的幂
+
+	/// @brief 原始路径记录
+	struct RawEntry
+	{
+		std::string Raw;  ///< @brief 原始路径
+		uint32_t ID;      ///< @brief 规范路径ID
+	};
+
+	/// @brief 原始路径分片
+	struct Shard
+	{
+		mutable std::shared_mutex Lock;
+		std::unordered_multimap<uint32_t, RawEntry> Map;
+	};
+private:
+	Shard m_Shards[ShardCount];                                   ///< @brief 原始路径到ID
+	mutable std::shared_mutex m_CanonicalLock;                    ///< @brief 规范路径表锁
+	std::deque<std::string> m_Canonical;                          ///< @brief ID到规范路径，deque保证元素地址稳定
+	std::unordered_map<std::string_view, uint32_t> m_CanonicalID; ///< @brief 规范路径到ID，键引用m_Canonical
+private:
+	uint32_t internCanonical(std::string&& Canonical);
+public:
+	/// @brief     获得路径的规范ID
+	/// @note      首次遇到的原始路径会被规范化并记录
+	/// @param[in] RawPath 原始路径
+	/// @return    规范路径ID
+	uint32_t GetID(std::string_view RawPath);
+
+	/// @brief     查找已记录路径的规范ID
+	/// @param[in] RawPath 原始路径
+	/// @return    规范路径ID，未记录时返回InvalidID
+	uint32_t FindID(std::string_view RawPath)const;
+
+	/// @brief     获得ID对应的规范路径
+	/// @note      返回的引用在缓存清空前一直有效
+	/// @param[in] ID 规范路径ID
+	/// @return    规范路径，ID无效时返回空字符串
+	const std::string& GetCanonicalPath(uint32_t ID)const;
+
+	/// @brief 获得规范路径数量
+	uint32_t GetCanonicalCount()const;
+
+	/// @brief 获得已记录的原始路径数量
+	uint32_t GetRawCount()const;
+
+	/// @brief 清空缓存
+	/// @note  之前获得的ID和规范路径引用全部失效，调用方须保证没有并发访问
+	void Clear();
+public:
+	fcyPathCache();
+	~fcyPathCache();
+private:
+	fcyPathCache(const fcyPathCache&) = delete;
+	fcyPathCache& operator=(const fcyPathCache&) = delete;
+};
+/// @}
@@ -0,0 +1,486 @@
+﻿#include "fcyPathIndex.h"
+#include "fcyPathParser.h"
+
+#include "../fcyMisc/fcyStringHelper.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const uint32_t IndexMagic = 0x58495046;  // 'FPIX'
+static const uint32_t IndexVersion = 1;
+
+// 拆分规范路径，忽略根分隔符
+static void SplitSegments(string_view Normalized, vector<string_view>& Out)
+{
+	Out.clear();
+	size_t i = 0;
+	while(i < Normalized.size())
+	{
+		size_t tPos = Normalized.find('\\', i);
+		if(tPos == string_view::npos)
+			tPos = Normalized.size();
+		if(tPos > i)
+			Out.push_back(Normalized.substr(i, tPos - i));
+		i = tPos + 1;
+	}
+}
+
+// 段内通配符匹配
+static bool MatchWildcard(string_view Pattern, string_view Name)
+{
+	size_t p = 0, n = 0;
+	size_t tStar = string_view::npos, tMark = 0;
+	while(n < Name.size())
+	{
+		if(p < Pattern.size() && (Pattern[p] == '?' || Pattern[p] == Name[n]))
+		{
+			++p; ++n;
+		}
+		else if(p < Pattern.size() && Pattern[p] == '*')
+		{
+			tStar = p++;
+			tMark = n;
+		}
+		else if(tStar != string_view::npos)
+		{
+			p = tStar + 1;
+			n = ++tMark;
+		}
+		else
+			return false;
+	}
+	while(p < Pattern.size() && Pattern[p] == '*')
+		++p;
+	return p == Pattern.size();
+}
+
+static bool HasWildcard(string_view Segment)
+{
+	return Segment.find_first_of("*?") != string_view::npos;
+}
+
+fcyPathIndex::fcyPathIndex()
+	: m_pHeader(nullptr), m_pNodes(nullptr), m_pNames(nullptr)
+{
+	Clear();
+}
+
+fcyPathIndex::~fcyPathIndex()
+{
+}
+
+bool fcyPathIndex::Add(string_view Path, uint32_t Value)
+{
+	// 使用外部映像时没有构建期节点，索引只读
+	if(m_BuildNodes.empty())
+		return false;
+
+	string tNormalized = fcyPathParser::Normalize(Path);
+	vector<string_view> tSegments;
+	SplitSegments(tNormalized, tSegments);
+	if(tSegments.empty())
+		return false;
+	for(auto& i : tSegments)
+	{
+		if(i.size() > 0xFFFF)
+			return false;
+	}
+
+	uint32_t tNode = RootNode;
+	for(size_t i = 0; i < tSegments.size(); ++i)
+	{
+		string tName(tSegments[i]);
+		auto tIt = m_BuildNodes[tNode].Children.find(tName);
+		if(tIt == m_BuildNodes[tNode].Children.end())
+		{
+			uint32_t tNew = (uint32_t)m_BuildNodes.size();
+			m_BuildNodes[tNode].Children.emplace(tName, tNew);
+			m_BuildNodes.push_back(BuildNode { move(tName), 0, 0, {} });
+			tNode = tNew;
+		}
+		else
+			tNode = tIt->second;
+
+		if(i + 1 < tSegments.size())
+			m_BuildNodes[tNode].Flags |= NodeFlag_Directory;
+	}
+
+	m_BuildNodes[tNode].Flags |= NodeFlag_File;
+	m_BuildNodes[tNode].Value = Value;
+	return true;
+}
+
+void fcyPathIndex::Build()
+{
+	if(m_BuildNodes.empty())
+		return;
+
+	// 广度优先排列，使同一目录的子节点连续
+	vector<ImageNode> tNodes;
+	vector<uint32_t> tOrder(1, RootNode);
+	vector<uint32_t> tParent(1, InvalidNode);
+	string tNames;
+
+	tNodes.reserve(m_BuildNodes.size());
+	tOrder.reserve(m_BuildNodes.size());
+	tParent.reserve(m_BuildNodes.size());
+	for(size_t i = 0; i < tOrder.size(); ++i)
+	{
+		const BuildNode& tSrc = m_BuildNodes[tOrder[i]];
+
+		ImageNode tNode;
+		tNode.NameOffset = (uint32_t)tNames.size();
+		tNode.NameLength = (uint16_t)tSrc.Name.size();
+		tNode.Flags = tSrc.Flags;
+		tNode.Parent = tParent[i];
+		tNode.FirstChild = (uint32_t)tOrder.size();
+		tNode.ChildCount = (uint32_t)tSrc.Children.size();
+		tNode.Value = tSrc.Value;
+		tNodes.push_back(tNode);
+		tNames += tSrc.Name;
+
+		for(auto& c : tSrc.Children)
+		{
+			tOrder.push_back(c.second);
+			tParent.push_back((uint32_t)i);
+		}
+	}
+
+	ImageHeader tHeader;
+	tHeader.Magic = IndexMagic;
+	tHeader.Version = IndexVersion;
+	tHeader.NodeCount = (uint32_t)tNodes.size();
+	tHeader.NameSize = (uint32_t)tNames.size();
+	tHeader.NodeOffset = sizeof(ImageHeader);
+	tHeader.NameOffset = tHeader.NodeOffset + tHeader.NodeCount * sizeof(ImageNode);
+	tHeader.ImageSize = (tHeader.NameOffset + tHeader.NameSize + 3) & ~3u;
+	tHeader.Reserved = 0;
+
+	m_ImageData.assign(tHeader.ImageSize / sizeof(uint32_t), 0);
+	uint8_t* p = (uint8_t*)m_ImageData.data();
+	memcpy(p, &tHeader, sizeof(tHeader));
+	memcpy(p + tHeader.NodeOffset, tNodes.data(), tNodes.size() * sizeof(ImageNode));
+	memcpy(p + tHeader.NameOffset, tNames.data(), tNames.size());
+
+	attachImage(m_ImageData.data(), tHeader.ImageSize);
+}
+
+bool fcyPathIndex::attachImage(const void* pData, size_t Len)
+{
+	if(!pData || Len < sizeof(ImageHeader) || ((uintptr_t)pData & 3) != 0)
+		return false;
+
+	const ImageHeader* pHeader = (const ImageHeader*)pData;
+	if(pHeader->Magic != IndexMagic || pHeader->Version != IndexVersion || pHeader->NodeCount == 0)
+		return false;
+	if(pHeader->ImageSize > Len || pHeader->NodeOffset < sizeof(ImageHeader) || (pHeader->NodeOffset & 3) != 0)
+		return false;
+	if((uint64_t)pHeader->NodeOffset + (uint64_t)pHeader->NodeCount * sizeof(ImageNode) > pHeader->ImageSize)
+		return false;
+	if((uint64_t)pHeader->NameOffset + pHeader->NameSize > pHeader->ImageSize)
+		return false;
+
+	// 校验节点引用，子节点总在父节点之后，保证遍历不会成环
+	const ImageNode* pNodes = (const ImageNode*)((const uint8_t*)pData + pHeader->NodeOffset);
+	for(uint32_t i = 0; i < pHeader->NodeCount; ++i)
+	{
+		const ImageNode& n = pNodes[i];
+		if((uint64_t)n.NameOffset + n.NameLength > pHeader->NameSize)
+			return false;
+		if(n.ChildCount > 0 && (n.FirstChild <= i || (uint64_t)n.FirstChild + n.ChildCount > pHeader->NodeCount))
+			return false;
+		if(i > 0 && n.Parent >= i)
+			return false;
+	}
+
+	m_pHeader = pHeader;
+	m_pNodes = pNodes;
+	m_pNames = (const char*)pData + pHeader->NameOffset;
+	return true;
+}
+
+bool fcyPathIndex::Attach(const void* pData, size_t Len)
+{
+	if(!attachImage(pData, Len))
+		return false;
+	m_ImageData.clear();
+	m_BuildNodes.clear();
+	return true;
+}
+
+bool fcyPathIndex::Load(const void* pData, size_t Len)
+{
+	// 映像大小以32位记录
+	if(!pData || Len < sizeof(ImageHeader) || Len > 0xFFFFFFFFu)
+		return false;
+
+	vector<uint32_t> tData((Len + 3) / sizeof(uint32_t), 0);
+	memcpy(tData.data(), pData, Len);
+	if(!attachImage(tData.data(), Len))
+		return false;
+	m_ImageData.swap(tData);
+	m_BuildNodes.clear();
+	return true;
+}
+
+const void* fcyPathIndex::GetImageData()const
+{
+	return m_pHeader;
+}
+
+size_t fcyPathIndex::GetImageSize()const
+{
+	return m_pHeader ? m_pHeader->ImageSize : 0;
+}
+
+void fcyPathIndex::Clear()
+{
+	m_BuildNodes.clear();
+	m_BuildNodes.push_back(BuildNode { string(), 0, NodeFlag_Directory, {} });
+	Build();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+string_view fcyPathIndex::nodeName(const ImageNode& Node)const
+{
+	return string_view(m_pNames + Node.NameOffset, Node.NameLength);
+}
+
+uint32_t fcyPathIndex::findChild(uint32_t Node, string_view Name)const
+{
+	const ImageNode& tNode = m_pNodes[Node];
+	uint32_t tLow = tNode.FirstChild;
+	uint32_t tHigh = tNode.FirstChild + tNode.ChildCount;
+	while(tLow < tHigh)
+	{
+		uint32_t tMid = tLow + (tHigh - tLow) / 2;
+		int tCmp = nodeName(m_pNodes[tMid]).compare(Name);
+		if(tCmp == 0)
+			return tMid;
+		if(tCmp < 0)
+			tLow = tMid + 1;
+		else
+			tHigh = tMid;
+	}
+	return InvalidNode;
+}
+
+uint32_t fcyPathIndex::findDirectory(const vector<string_view>& Segments, size_t Count)const
+{
+	uint32_t tNode = RootNode;
+	for(size_t i = 0; i < Count && tNode != InvalidNode; ++i)
+		tNode = findChild(tNode, Segments[i]);
+	return tNode;
+}
+
+void fcyPathIndex::collectFiles(uint32_t Node, vector<uint32_t>& Out)const
+{
+	const ImageNode& tNode = m_pNodes[Node];
+	if(tNode.Flags & NodeFlag_File)
+		Out.push_back(Node);
+	for(uint32_t i = 0; i < tNode.ChildCount; ++i)
+		collectFiles(tNode.FirstChild + i, Out);
+}
+
+void fcyPathIndex::collectExtension(uint32_t Node, string_view Ext, bool Recursive, vector<uint32_t>& Out)const
+{
+	const ImageNode& tNode = m_pNodes[Node];
+	for(uint32_t i = 0; i < tNode.ChildCount; ++i)
+	{
+		uint32_t tChild = tNode.FirstChild + i;
+		const ImageNode& c = m_pNodes[tChild];
+		if(c.Flags & NodeFlag_File)
+		{
+			fcyPathParser::PathView tView(nodeName(c));
+			if(tView.HasExtension() && fcyStringHelper::EqualsNoCase(tView.GetExtension(), Ext))
+				Out.push_back(tChild);
+		}
+		if(Recursive && c.ChildCount > 0)
+			collectExtension(tChild, Ext, Recursive, Out);
+	}
+}
+
+void fcyPathIndex::globNode(uint32_t Node, const vector<string_view>& Segments, size_t Index, vector<uint32_t>& Out)const
+{
+	const ImageNode& tNode = m_pNodes[Node];
+	if(Index == Segments.size())
+	{
+		if(tNode.Flags & NodeFlag_File)
+			Out.push_back(Node);
+		return;
+	}
+
+	string_view tSeg = Segments[Index];
+	if(tSeg == "**" && Index + 1 == Segments.size())
+	{
+		// 末尾的"**"匹配目录下的所有文件
+		for(uint32_t i = 0; i < tNode.ChildCount; ++i)
+			collectFiles(tNode.FirstChild + i, Out);
+	}
+	else if(tSeg == "**")
+	{
+		globNode(Node, Segments, Index + 1, Out);
+		for(uint32_t i = 0; i < tNode.ChildCount; ++i)
+		{
+			if(m_pNodes[tNode.FirstChild + i].ChildCount > 0)
+				globNode(tNode.FirstChild + i, Segments, Index, Out);
+		}
+	}
+	else if(!HasWildcard(tSeg))
+	{
+		uint32_t tChild = findChild(Node, tSeg);
+		if(tChild != InvalidNode)
+			globNode(tChild, Segments, Index + 1, Out);
+	}
+	else
+	{
+		for(uint32_t i = 0; i < tNode.ChildCount; ++i)
+		{
+			uint32_t tChild = tNode.FirstChild + i;
+			if(MatchWildcard(tSeg, nodeName(m_pNodes[tChild])))
+				globNode(tChild, Segments, Index + 1, Out);
+		}
+	}
+}
+
+uint32_t fcyPathIndex::Find(string_view Path)const
+{
+	string tNormalized = fcyPathParser::Normalize(Path);
+	vector<string_view> tSegments;
+	SplitSegments(tNormalized, tSegments);
+	return findDirectory(tSegments, tSegments.size());
+}
+
+bool fcyPathIndex::FindValue(string_view Path, uint32_t& Out)const
+{
+	uint32_t tNode = Find(Path);
+	if(tNode == InvalidNode || !(m_pNodes[tNode].Flags & NodeFlag_File))
+		return false;
+	Out = m_pNodes[tNode].Value;
+	return true;
+}
+
+void fcyPathIndex::ListDirectory(string_view Dir, vector<uint32_t>& Out)const
+{
+	uint32_t tNode = Find(Dir);
+	if(tNode == InvalidNode)
+		return;
+	const ImageNode& tDir = m_pNodes[tNode];
+	for(uint32_t i = 0; i < tDir.ChildCount; ++i)
+		Out.push_back(tDir.FirstChild + i);
+}
+
+void fcyPathIndex::QueryPrefix(string_view Prefix, vector<uint32_t>& Out)const
+{
+	string tNormalized = fcyPathParser::Normalize(Prefix);
+	vector<string_view> tSegments;
+	SplitSegments(tNormalized, tSegments);
+
+	// 以分隔符结尾或为空时按目录处理
+	if(Prefix.empty() || fcyPathParser::PathView::IsSeparator(Prefix.back()) || tSegments.empty())
+	{
+		uint32_t tNode = findDirectory(tSegments, tSegments.size());
+		if(tNode == InvalidNode)
+			return;
+		const ImageNode& tDir = m_pNodes[tNode];
+		for(uint32_t i = 0; i < tDir.ChildCount; ++i)
+			collectFiles(tDir.FirstChild + i, Out);
+		return;
+	}
+
+	uint32_t tNode = findDirectory(tSegments, tSegments.size() - 1);
+	if(tNode == InvalidNode)
+		return;
+
+	// 子节点有序，名称前缀相同的节点连续
+	string_view tName = tSegments.back();
+	const ImageNode& tDir = m_pNodes[tNode];
+	const ImageNode* pBegin = m_pNodes + tDir.FirstChild;
+	const ImageNode* pEnd = pBegin + tDir.ChildCount;
+	const ImageNode* p = lower_bound(pBegin, pEnd, tName, [this](const ImageNode& n, string_view v) {
+		return nodeName(n) < v;
+	});
+	for(; p != pEnd && nodeName(*p).substr(0, tName.size()) == tName; ++p)
+		collectFiles((uint32_t)(p - m_pNodes), Out);
+}
+
+void fcyPathIndex::QueryExtension(string_view Dir, string_view Ext, bool Recursive, vector<uint32_t>& Out)const
+{
+	uint32_t tNode = Find(Dir);
+	if(tNode == InvalidNode)
+		return;
+	if(!Ext.empty() && Ext[0] == '.')
+		Ext.remove_prefix(1);
+	collectExtension(tNode, Ext, Recursive, Out);
+}
+
+void fcyPathIndex::Glob(string_view Pattern, vector<uint32_t>& Out)const
+{
+	string tNormalized = fcyPathParser::Normalize(Pattern);
+	vector<string_view> tSegments;
+	SplitSegments(tNormalized, tSegments);
+	if(tSegments.empty())
+		return;
+
+	size_t tBegin = Out.size();
+	globNode(RootNode, tSegments, 0, Out);
+
+	// 多个"**"可能重复匹配同一节点
+	if(count(tSegments.begin(), tSegments.end(), "**") > 0)
+	{
+		sort(Out.begin() + tBegin, Out.end());
+		Out.erase(unique(Out.begin() + tBegin, Out.end()), Out.end());
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t fcyPathIndex::GetNodeCount()const
+{
+	return m_pHeader->NodeCount;
+}
+
+string_view fcyPathIndex::GetName(uint32_t Node)const
+{
+	return nodeName(m_pNodes[Node]);
+}
+
+string fcyPathIndex::GetFullPath(uint32_t Node)const
+{
+	vector<uint32_t> tChain;
+	for(uint32_t i = Node; i != RootNode && i != InvalidNode; i = m_pNodes[i].Parent)
+		tChain.push_back(i);
+
+	string tRet;
+	for(auto i = tChain.rbegin(); i != tChain.rend(); ++i)
+	{
+		if(!tRet.empty())
+			tRet += '\\';
+		tRet += nodeName(m_pNodes[*i]);
+	}
+	return tRet;
+}
+
+uint32_t fcyPathIndex::GetParent(uint32_t Node)const
+{
+	return m_pNodes[Node].Parent;
+}
+
+uint32_t fcyPathIndex::GetValue(uint32_t Node)const
+{
+	return m_pNodes[Node].Value;
+}
+
+bool fcyPathIndex::IsFile(uint32_t Node)const
+{
+	return (m_pNodes[Node].Flags & NodeFlag_File) != 0;
+}
+
+bool fcyPathIndex::IsDirectory(uint32_t Node)const
+{
+	return m_pNodes[Node].ChildCount > 0 || (m_pNodes[Node].Flags & NodeFlag_Directory) != 0;
+}
@@ -0,0 +1,176 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyPathIndex.h
+/// @brief fcy路径索引
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+
+/// @addtogroup fancy库解析辅助
+/// @{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 目录前缀树索引
+/// @note  路径经fcyPathParser::Normalize规范化后按段插入前缀树。
+///        Build后所有节点存放在一块连续的二进制映像中：节点数组按广度优先排列，
+///        同一目录的子节点连续且按名称排序，名称存放在同一块字符区中。
+///        映像不含指针，可直接保存到文件，之后通过Attach从内存映射中使用而无需重建。
+///        映像使用本机字节序。
+////////////////////////////////////////////////////////////////////////////////
+class fcyPathIndex
+{
+public:
+	static constexpr uint32_t InvalidNode = 0xFFFFFFFFu; ///< @brief 无效节点
+	static constexpr uint32_t RootNode = 0;          ///< @brief 根节点
+
+	/// @brief 节点标记
+	enum NodeFlag
+	{
+		NodeFlag_File = 1,      ///< @brief 文件
+		NodeFlag_Directory = 2  ///< @brief 目录
+	};
+private:
+	/// @brief 映像头
+	struct ImageHeader
+	{
+		uint32_t Magic;       ///< @brief 标识
+		uint32_t Version;     ///< @brief 版本
+		uint32_t NodeCount;   ///< @brief 节点数量
+		uint32_t NameSize;    ///< @brief 名称区字节数
+		uint32_t NodeOffset;  ///< @brief 节点数组偏移
+		uint32_t NameOffset;  ///< @brief 名称区偏移
+		uint32_t ImageSize;   ///< @brief 映像总大小
+		uint32_t Reserved;    ///< @brief 保留
+	};
+
+	/// @brief 映像中的节点
+	struct ImageNode
+	{
+		uint32_t NameOffset;  ///< @brief 名称在名称区中的偏移
+		uint16_t NameLength;  ///< @brief 名称长度
+		uint16_t Flags;       ///< @brief NodeFlag组合
+		uint32_t Parent;      ///< @brief 父节点
+		uint32_t FirstChild;  ///< @brief 第一个子节点
+		uint32_t ChildCount;  ///< @brief 子节点数量
+		uint32_t Value;       ///< @brief 用户数据
+	};
+
+	/// @brief 构建期节点
+	struct BuildNode
+	{
+		std::string Name;
+		uint32_t Value;
+		uint16_t Flags;
+		std::map<std::string, uint32_t> Children;
+	};
+private:
+	std::vector<BuildNode> m_BuildNodes;  ///< @brief 构建期节点，0为根
+	std::vector<uint32_t> m_ImageData;    ///< @brief 自有映像（按4字节对齐）
+	const ImageHeader* m_pHeader;         ///< @brief 当前映像头
+	const ImageNode* m_pNodes;            ///< @brief 当前节点数组
+	const char* m_pNames;                 ///< @brief 当前名称区
+private:
+	bool attachImage(const void* pData, size_t Len);
+	std::string_view nodeName(const ImageNode& Node)const;
+	uint32_t findChild(uint32_t Node, std::string_view Name)const;
+	uint32_t findDirectory(const std::vector<std::string_view>& Segments, size_t Count)const;
+	void collectFiles(uint32_t Node, std::vector<uint32_t>& Out)const;
+	void collectExtension(uint32_t Node, std::string_view Ext, bool Recursive, std::vector<uint32_t>& Out)const;
+	void globNode(uint32_t Node, const std::vector<std::string_view>& Segments, size_t Index, std::vector<uint32_t>& Out)const;
+public:
+	/// @brief     添加路径
+	/// @note      须调用Build后才能查询；路径中的中间段自动成为目录
+	/// @param[in] Path  路径
+	/// @param[in] Value 用户数据，重复添加时覆盖
+	/// @return    路径为空、某段超过65535字节或索引只读时返回false
+	bool Add(std::string_view Path, uint32_t Value);
+
+	/// @brief 由已添加的路径生成映像
+	/// @note  索引只读时不做任何事
+	void Build();
+
+	/// @brief     使用外部映像，不复制
+	/// @note      数据须4字节对齐，且在使用期间保持有效，通常为内存映射的文件。
+	///            成功后丢弃之前添加的路径，索引变为只读，调用Clear后才能重新添加
+	/// @param[in] pData 映像数据
+	/// @param[in] Len   映像字节数
+	/// @return    映像无效时返回false
+	bool Attach(const void* pData, size_t Len);
+
+	/// @brief     复制并使用外部映像
+	/// @note      成功后与Attach相同，索引变为只读
+	/// @param[in] pData 映像数据
+	/// @param[in] Len   映像字节数
+	/// @return    映像无效时返回false
+	bool Load(const void* pData, size_t Len);
+
+	/// @brief 获得当前映像数据，用于保存
+	const void* GetImageData()const;
+
+	/// @brief 获得当前映像字节数
+	size_t GetImageSize()const;
+
+	/// @brief 清空索引
+	void Clear();
+public: // 查询
+	/// @brief     精确查找
+	/// @param[in] Path 路径
+	/// @return    节点，不存在时返回InvalidNode
+	uint32_t Find(std::string_view Path)const;
+
+	/// @brief      查找文件的用户数据
+	/// @param[in]  Path 路径
+	/// @param[out] Out  用户数据
+	/// @return     文件不存在时返回false
+	bool FindValue(std::string_view Path, uint32_t& Out)const;
+
+	/// @brief      列出目录的直接子节点（文件与子目录）
+	/// @param[in]  Dir 目录
+	/// @param[out] Out 输出的节点，按名称排序
+	void ListDirectory(std::string_view Dir, std::vector<uint32_t>& Out)const;
+
+	/// @brief      查询路径前缀下的所有文件
+	/// @note       以分隔符结尾时表示目录，否则最后一段按名称前缀匹配
+	/// @param[in]  Prefix 路径前缀，如"image/boss/"或"image/boss/st"
+	/// @param[out] Out    输出的文件节点
+	void QueryPrefix(std::string_view Prefix, std::vector<uint32_t>& Out)const;
+
+	/// @brief      查询目录下指定后缀的文件
+	/// @param[in]  Dir       目录，为空时表示根目录
+	/// @param[in]  Ext       后缀，忽略大小写，可带'.'
+	/// @param[in]  Recursive 是否包含子目录
+	/// @param[out] Out       输出的文件节点
+	void QueryExtension(std::string_view Dir, std::string_view Ext, bool Recursive, std::vector<uint32_t>& Out)const;
+
+	/// @brief      通配符查询文件
+	/// @note       '?'匹配一个字符，'*'匹配段内任意字符，"**"匹配任意层目录；
+	///             位于末尾的"**"匹配该目录下任意层的所有文件，如"image/**"
+	/// @param[in]  Pattern 模式，如"image/**/*.png"
+	/// @param[out] Out     输出的文件节点
+	void Glob(std::string_view Pattern, std::vector<uint32_t>& Out)const;
+public: // 节点访问
+	/// @brief 获得节点数量
+	uint32_t GetNodeCount()const;
+	/// @brief 获得节点名称（规范化后的单段名称）
+	std::string_view GetName(uint32_t Node)const;
+	/// @brief 获得节点的规范完整路径
+	std::string GetFullPath(uint32_t Node)const;
+	/// @brief 获得父节点
+	uint32_t GetParent(uint32_t Node)const;
+	/// @brief 获得用户数据
+	uint32_t GetValue(uint32_t Node)const;
+	/// @brief 是否为文件
+	bool IsFile(uint32_t Node)const;
+	/// @brief 是否为目录
+	bool IsDirectory(uint32_t Node)const;
+public:
+	fcyPathIndex();
+	~fcyPathIndex();
+private:
+	fcyPathIndex(const fcyPathIndex&) = delete;
+	fcyPathIndex& operator=(const fcyPathIndex&) = delete;
+};
+/// @}
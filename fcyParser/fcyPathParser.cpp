@@ -25,71 +25,99 @@ static wchar_t TransCharW(wchar_t x)
 
 string fcyPathParser::GetExtension(const string& Path)
 {
-	string tRet = GetFileName(Path);
-
-	auto tPos = tRet.find_last_of(L'.');
-	if(tPos != string::npos)
-		tRet.erase(0, tPos + 1);
-
-	return tRet;
+	PathView tView(Path);
+	return string(tView.HasExtension() ? tView.GetExtension() : tView.GetFileName());
 }
 
 string fcyPathParser::GetExtensionLower(const string& Path)
 {
 	string tRet = GetExtension(Path);
-	return fcyStringHelper::ToLower(tRet);
+	fcyStringHelper::ToLowerInPlace(tRet);
+	return tRet;
 }
 
 string fcyPathParser::GetFileName(const string& Path)
 {
-	string tRet = Path;
-	transform(tRet.begin(), tRet.end(), tRet.begin(), TransCharA);
-
-	auto tPos = Path.find_last_of(L'\\');
-	if(tPos != string::npos)
-		tRet.erase(0, tPos + 1);
-
-	return tRet;
+	return string(PathView(Path).GetFileName());
 }
 
 string fcyPathParser::GetFileNameWithoutExt(const string& Path)
 {
-	string tRet = GetFileName(Path);
-
-	auto tPos = tRet.find_last_of(L'.');
-	if(tPos != string::npos)
-		tRet.erase(tPos, tRet.length() - tPos);
-
-	return tRet;
+	return string(PathView(Path).GetStem());
 }
 
 string fcyPathParser::GetPath(const string& Path)
 {
-	string tRet = Path;
+	string_view tDir = PathView(Path).GetDirectory();
+	string tRet(tDir.empty() ? string_view(Path) : tDir);
 	transform(tRet.begin(), tRet.end(), tRet.begin(), TransCharA);
 
 	if(tRet.length()>0 && tRet[tRet.length()-1]!='\\')
+		tRet += '\\';
+
+	return tRet;
+}
+
+string fcyPathParser::Normalize(string_view Path)
+{
+	string tRet;
+	tRet.reserve(Path.size());
+
+	// 盘符与其后的分隔符一起构成根，".."不能越过
+	if(Path.size() >= 2 && Path[1] == ':' && ((Path[0] | 0x20) >= 'a' && (Path[0] | 0x20) <= 'z'))
 	{
-		auto tPos = tRet.find_last_of(L'\\');
-		if(tPos != string::npos)
-			tRet.erase(tPos, tRet.length() - tPos);
+		tRet += (char)(Path[0] | 0x20);
+		tRet += ':';
+		Path.remove_prefix(2);
 	}
 
-	if(tRet.length()>0 && tRet[tRet.length()-1]!='\\')
+	const bool tAbsolute = !Path.empty() && PathView::IsSeparator(Path[0]);
+	if(tAbsolute)
 		tRet += '\\';
+	const size_t tRoot = tRet.size();  // 不可回退的前缀长度
+
+	size_t i = 0;
+	while(i < Path.size())
+	{
+		// 取出一段
+		while(i < Path.size() && PathView::IsSeparator(Path[i]))
+			++i;
+		size_t tStart = i;
+		while(i < Path.size() && !PathView::IsSeparator(Path[i]))
+			++i;
+		string_view tSeg = Path.substr(tStart, i - tStart);
+
+		if(tSeg.empty() || tSeg == ".")
+			continue;
+
+		if(tSeg == "..")
+		{
+			// 回退上一段，上一段本身为".."时不能回退
+			size_t tLast = tRet.find_last_of('\\');
+			tLast = (tLast == string::npos || tLast < tRoot) ? tRoot : tLast + 1;
+			if(tRet.size() > tRoot && string_view(tRet).substr(tLast) != "..")
+			{
+				tRet.erase(tLast > tRoot ? tLast - 1 : tRoot);
+				continue;
+			}
+			if(tAbsolute)
+				continue;
+		}
+
+		if(tRet.size() > tRoot)
+			tRet += '\\';
+		size_t tPos = tRet.size();
+		tRet.append(tSeg.data(), tSeg.size());
+		fcyStringHelper::ToLowerInPlace(&tRet[tPos], tSeg.size());
+	}
 
 	return tRet;
 }
 
 wstring fcyPathParser::GetExtension(const wstring& Path)
 {
-	wstring tRet = GetFileName(Path);
-
-	auto tPos = tRet.find_last_of(L'.');
-	if(tPos != wstring::npos)
-		tRet.erase(0, tPos + 1);
-
-	return tRet;
+	WPathView tView(Path);
+	return wstring(tView.HasExtension() ? tView.GetExtension() : tView.GetFileName());
 }
 
 wstring fcyPathParser::GetExtensionLower(const wstring& Path)
@@ -100,39 +128,20 @@ wstring fcyPathParser::GetExtensionLower(const wstring& Path)
 
 wstring fcyPathParser::GetFileName(const wstring& Path)
 {
-	wstring tRet = Path;
-	transform(tRet.begin(), tRet.end(), tRet.begin(), TransCharW);
-
-	auto tPos = Path.find_last_of(L'\\');
-	if(tPos != wstring::npos)
-		tRet.erase(0, tPos + 1);
-
-	return tRet;
+	return wstring(WPathView(Path).GetFileName());
 }
 
 wstring fcyPathParser::GetFileNameWithoutExt(const wstring& Path)
 {
-	wstring tRet = GetFileName(Path);
-
-	auto tPos = tRet.find_last_of(L'.');
-	if(tPos != wstring::npos)
-		tRet.erase(tPos, tRet.length() - tPos);
-
-	return tRet;
+	return wstring(WPathView(Path).GetStem());
 }
 
 wstring fcyPathParser::GetPath(const wstring& Path)
 {
-	wstring tRet = Path;
+	wstring_view tDir = WPathView(Path).GetDirectory();
+	wstring tRet(tDir.empty() ? wstring_view(Path) : tDir);
 	transform(tRet.begin(), tRet.end(), tRet.begin(), TransCharW);
 
-	if(tRet.length()>0 && tRet[tRet.length()-1]!='\\')
-	{
-		auto tPos = tRet.find_last_of(L'\\');
-		if(tPos != wstring::npos)
-			tRet.erase(tPos, tRet.length() - tPos);
-	}
-
 	if(tRet.length()>0 && tRet[tRet.length()-1]!='\\')
 		tRet += '\\';
 
@@ -4,6 +4,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include <string>
+#include <string_view>
 
 /// @addtogroup fancy库解析辅助
 /// @{
@@ -11,6 +12,66 @@
 /// @brief Fcy路径解析函数
 namespace fcyPathParser
 {
+	////////////////////////////////////////////////////////////////////////////////
+	/// @brief 路径分解视图
+	/// @note  构造时从尾部单次扫描，各部分均为原始路径的子视图，不分配内存。
+	///        '/'、'\\'、'|'均视为分隔符。
+	////////////////////////////////////////////////////////////////////////////////
+	template<typename CharT>
+	class BasicPathView
+	{
+	public:
+		typedef std::basic_string_view<CharT> ViewType;
+	private:
+		ViewType m_Path;  ///< @brief 原始路径
+		size_t m_NamePos; ///< @brief 文件名起始位置
+		size_t m_DotPos;  ///< @brief 文件名中最后一个'.'的位置，没有时为npos
+	public:
+		/// @brief 是否为分隔符
+		static bool IsSeparator(CharT c)
+		{
+			return c == CharT('/') || c == CharT('\\') || c == CharT('|');
+		}
+	public:
+		/// @brief 原始路径
+		ViewType GetFullPath()const { return m_Path; }
+		/// @brief 目录部分，包含末尾的分隔符，没有目录时为空
+		ViewType GetDirectory()const { return m_Path.substr(0, m_NamePos); }
+		/// @brief 文件名
+		ViewType GetFileName()const { return m_Path.substr(m_NamePos); }
+		/// @brief 去后缀文件名
+		ViewType GetStem()const
+		{
+			return m_DotPos == ViewType::npos ? GetFileName() : m_Path.substr(m_NamePos, m_DotPos - m_NamePos);
+		}
+		/// @brief 后缀，不含'.'，没有后缀时为空
+		ViewType GetExtension()const
+		{
+			return m_DotPos == ViewType::npos ? ViewType() : m_Path.substr(m_DotPos + 1);
+		}
+		/// @brief 是否有后缀
+		bool HasExtension()const { return m_DotPos != ViewType::npos; }
+	public:
+		BasicPathView(ViewType Path)
+			: m_Path(Path), m_NamePos(0), m_DotPos(ViewType::npos)
+		{
+			for (size_t i = Path.size(); i > 0; --i)
+			{
+				CharT c = Path[i - 1];
+				if (IsSeparator(c))
+				{
+					m_NamePos = i;
+					break;
+				}
+				if (c == CharT('.') && m_DotPos == ViewType::npos)
+					m_DotPos = i - 1;
+			}
+		}
+	};
+
+	typedef BasicPathView<char> PathView;     ///< @brief 路径分解视图
+	typedef BasicPathView<wchar_t> WPathView; ///< @brief 路径分解视图，宽字符版
+
 	/// @brief     获得后缀
 	/// @param[in] Path 路径
 	/// @return    返回后缀
@@ -36,6 +97,14 @@ namespace fcyPathParser
 	/// @return    返回目录
 	std::string GetPath(const std::string& Path);
 
+	/// @brief     规范化路径
+	/// @note      分隔符统一为'\\'并合并重复，移除"."，解析".."，ASCII字母转小写，去掉末尾分隔符。
+	///            无法回退的".."在相对路径中保留，在绝对路径中丢弃。
+	///            开头的盘符（如"C:"）转小写并作为根的一部分，".."不会将其移除。
+	/// @param[in] Path 路径
+	/// @return    返回规范路径
+	std::string Normalize(std::string_view Path);
+
 	/// @brief     获得后缀，宽字符版
 	/// @param[in] Path 路径
 	/// @return    返回后缀
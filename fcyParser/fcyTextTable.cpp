@@ -0,0 +1,177 @@
+﻿#include "fcyTextTable.h"
+#include "../fcyMisc/fcyStringHelper.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	// 在Count个线程上执行Func(i)，第0项在调用线程上执行
+	template<typename F>
+	void RunParallel(size_t Count, F&& Func)
+	{
+		vector<thread> tWorkers;
+		tWorkers.reserve(Count > 0 ? Count - 1 : 0);
+		for (size_t i = 1; i < Count; ++i)
+			tWorkers.emplace_back([&Func, i]() { Func(i); });
+		if (Count > 0)
+			Func(0);
+		for (thread& t : tWorkers)
+			t.join();
+	}
+}
+
+fcyTextTable::fcyTextTable()
+{
+	m_RecordStart.push_back(0);
+}
+
+void fcyTextTable::Clear()
+{
+	m_File.Close();
+	m_Fields.clear();
+	m_RecordStart.clear();
+	m_RecordStart.push_back(0);
+	m_RecordLine.clear();
+}
+
+bool fcyTextTable::LoadFile(const string& Path, const Options& Opt)
+{
+	Clear();
+	fcyMappedFile tFile;
+	if (!tFile.Open(Path))
+		return false;
+	m_File = move(tFile);
+	Parse(m_File.GetView(), Opt);
+	return true;
+}
+
+string_view fcyTextTable::GetField(size_t Record, uint32_t Field)const
+{
+	if (Record >= GetRecordCount() || Field >= GetFieldCount(Record))
+		return string_view();
+	return m_Fields[m_RecordStart[Record] + Field];
+}
+
+void fcyTextTable::parseChunk(Chunk& Dest, const Options& Opt)
+{
+	string_view tText = Dest.Text;
+	string_view tSep = Opt.FieldSeparator;
+	string_view tComment = Opt.CommentPrefix;
+
+	// 按平均行长粗略预留，避免反复扩容
+	Dest.Fields.reserve(tText.size() / 16 + 1);
+	Dest.RecordEnd.reserve(tText.size() / 64 + 1);
+	Dest.RecordLine.reserve(tText.size() / 64 + 1);
+
+	uint32_t tLine = 0;
+	size_t tPos = 0;
+	while (tPos < tText.size())
+	{
+		const char* pEnd = (const char*)memchr(tText.data() + tPos, '\n', tText.size() - tPos);
+		size_t tEnd = pEnd ? (size_t)(pEnd - tText.data()) : tText.size();
+		string_view tRow = tText.substr(tPos, tEnd - tPos);
+		tPos = tEnd + 1;
+		uint32_t tRowIndex = tLine++;
+
+		if (!tRow.empty() && tRow.back() == '\r')
+			tRow.remove_suffix(1);
+		if (!tComment.empty() && tRow.compare(0, tComment.size(), tComment) == 0)
+			continue;
+		if (Opt.SkipEmptyLines && (Opt.TrimFields ? fcyStringHelper::TrimView(tRow) : tRow).empty())
+			continue;
+
+		if (tSep.empty())
+			Dest.Fields.push_back(Opt.TrimFields ? fcyStringHelper::TrimView(tRow) : tRow);
+		else
+		{
+			size_t tLast = 0;
+			while (true)
+			{
+				size_t tFound = tRow.find(tSep, tLast);
+				string_view tField = tRow.substr(tLast, tFound == string_view::npos ? string_view::npos : tFound - tLast);
+				Dest.Fields.push_back(Opt.TrimFields ? fcyStringHelper::TrimView(tField) : tField);
+				if (tFound == string_view::npos)
+					break;
+				tLast = tFound + tSep.size();
+			}
+		}
+		Dest.RecordEnd.push_back((uint32_t)Dest.Fields.size());
+		Dest.RecordLine.push_back(tRowIndex);
+	}
+	Dest.LineCount = tLine;
+}
+
+void fcyTextTable::Parse(string_view Text, const Options& Opt)
+{
+	m_Fields.clear();
+	m_RecordStart.clear();
+	m_RecordStart.push_back(0);
+	m_RecordLine.clear();
+
+	// 跳过UTF-8 BOM
+	if (Text.size() >= 3 && memcmp(Text.data(), "\xEF\xBB\xBF", 3) == 0)
+		Text.remove_prefix(3);
+	if (Text.empty())
+		return;
+
+	// 决定块数
+	size_t tThreads = Opt.ThreadCount ? Opt.ThreadCount : max(1u, thread::hardware_concurrency());
+	size_t tMinChunk = max<size_t>(Opt.MinChunkSize, 1);
+	size_t tChunkCount = min(tThreads, max<size_t>(Text.size() / tMinChunk, 1));
+
+	// 按换行对齐切分，保证每行完整地落在一个块中
+	vector<Chunk> tChunks;
+	tChunks.reserve(tChunkCount);
+	size_t tBegin = 0;
+	for (size_t i = 1; i <= tChunkCount && tBegin < Text.size(); ++i)
+	{
+		size_t tEnd = Text.size();
+		if (i < tChunkCount)
+		{
+			size_t tGuess = max(tBegin, Text.size() / tChunkCount * i);
+			const char* p = (const char*)memchr(Text.data() + tGuess, '\n', Text.size() - tGuess);
+			tEnd = p ? (size_t)(p - Text.data()) + 1 : Text.size();
+		}
+		tChunks.emplace_back();
+		tChunks.back().Text = Text.substr(tBegin, tEnd - tBegin);
+		tChunks.back().LineCount = 0;
+		tBegin = tEnd;
+	}
+
+	RunParallel(tChunks.size(), [&](size_t i) { parseChunk(tChunks[i], Opt); });
+
+	// 计算各块在结果中的起始位置
+	vector<size_t> tFieldBase(tChunks.size()), tRecordBase(tChunks.size());
+	vector<uint32_t> tLineBase(tChunks.size());
+	size_t tFieldTotal = 0, tRecordTotal = 0;
+	uint32_t tLineTotal = 0;
+	for (size_t i = 0; i < tChunks.size(); ++i)
+	{
+		tFieldBase[i] = tFieldTotal;
+		tRecordBase[i] = tRecordTotal;
+		tLineBase[i] = tLineTotal;
+		tFieldTotal += tChunks[i].Fields.size();
+		tRecordTotal += tChunks[i].RecordLine.size();
+		tLineTotal += tChunks[i].LineCount;
+	}
+
+	// 按文件顺序合并，各块写入互不重叠的区间
+	m_Fields.resize(tFieldTotal);
+	m_RecordStart.resize(tRecordTotal + 1);
+	m_RecordLine.resize(tRecordTotal);
+	RunParallel(tChunks.size(), [&](size_t i) {
+		Chunk& c = tChunks[i];
+		copy(c.Fields.begin(), c.Fields.end(), m_Fields.begin() + tFieldBase[i]);
+		for (size_t j = 0; j < c.RecordLine.size(); ++j)
+		{
+			m_RecordStart[tRecordBase[i] + j + 1] = (uint32_t)(tFieldBase[i] + c.RecordEnd[j]);
+			m_RecordLine[tRecordBase[i] + j] = tLineBase[i] + c.RecordLine[j] + 1;
+		}
+	});
+}
@@ -0,0 +1,99 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyTextTable.h
+/// @brief fcy行文本表解析器
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../fcyMisc/fcyMappedFile.h"
+
+/// @addtogroup fancy库解析辅助
+/// @{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 行文本表解析器
+/// @note  以行为记录、以分隔符切分字段的文本（如CSV、TSV、列表文件）。
+///        输入按换行对齐切分成若干块并行解析，结果按文件顺序合并。
+///        所有字段均为指向源文本的视图，解析过程不为单个字段或行分配内存。
+///        不处理引号转义。
+////////////////////////////////////////////////////////////////////////////////
+class fcyTextTable
+{
+public:
+	/// @brief 解析选项
+	struct Options
+	{
+		std::string FieldSeparator;  ///< @brief 字段分隔符，为空时整行作为一个字段
+		std::string CommentPrefix;   ///< @brief 注释行前缀，为空时不识别注释
+		bool TrimFields;             ///< @brief 去除字段首尾空白
+		bool SkipEmptyLines;         ///< @brief 跳过空行（TrimFields时含仅有空白的行）
+		uint32_t ThreadCount;        ///< @brief 最大线程数，0为自动
+		size_t MinChunkSize;         ///< @brief 每块最小字节数，小于此值的输入不会被拆分
+
+		Options()
+			: FieldSeparator(","), TrimFields(true), SkipEmptyLines(true),
+			ThreadCount(0), MinChunkSize(256 * 1024) {}
+	};
+private:
+	/// @brief 单块的解析结果
+	struct Chunk
+	{
+		std::string_view Text;                ///< @brief 块文本
+		std::vector<std::string_view> Fields; ///< @brief 字段
+		std::vector<uint32_t> RecordEnd;      ///< @brief 每条记录结束时的字段数
+		std::vector<uint32_t> RecordLine;     ///< @brief 每条记录在块内的行号（0起）
+		uint32_t LineCount;                   ///< @brief 块内行数
+	};
+private:
+	fcyMappedFile m_File;                  ///< @brief 自有文件映射
+	std::vector<std::string_view> m_Fields; ///< @brief 所有字段
+	std::vector<uint32_t> m_RecordStart;   ///< @brief 每条记录首字段下标，末尾附加总数
+	std::vector<uint32_t> m_RecordLine;    ///< @brief 每条记录的行号（1起）
+private:
+	static void parseChunk(Chunk& Dest, const Options& Opt);
+public:
+	/// @brief     映射并解析文件
+	/// @param[in] Path 文件路径，UTF-8编码
+	/// @param[in] Opt  解析选项
+	/// @return    无法打开文件时返回false
+	bool LoadFile(const std::string& Path, const Options& Opt = Options());
+
+	/// @brief     解析外部文本
+	/// @note      Text必须在本对象使用期间保持有效
+	/// @param[in] Text 文本
+	/// @param[in] Opt  解析选项
+	void Parse(std::string_view Text, const Options& Opt = Options());
+
+	/// @brief 清空
+	void Clear();
+
+	/// @brief 获得记录数
+	size_t GetRecordCount()const { return m_RecordLine.size(); }
+
+	/// @brief 获得字段总数
+	size_t GetTotalFieldCount()const { return m_Fields.size(); }
+
+	/// @brief 获得记录的字段数
+	uint32_t GetFieldCount(size_t Record)const { return m_RecordStart[Record + 1] - m_RecordStart[Record]; }
+
+	/// @brief     获得字段
+	/// @note      越界时返回空视图
+	std::string_view GetField(size_t Record, uint32_t Field)const;
+
+	/// @brief 获得记录首字段指针，与GetFieldCount配合遍历
+	const std::string_view* GetRecord(size_t Record)const { return m_Fields.data() + m_RecordStart[Record]; }
+
+	/// @brief 获得记录所在行号（1起）
+	uint32_t GetLineNumber(size_t Record)const { return m_RecordLine[Record]; }
+public:
+	fcyTextTable();
+	fcyTextTable(fcyTextTable&&) = default;
+	fcyTextTable& operator=(fcyTextTable&&) = default;
+private:
+	fcyTextTable(const fcyTextTable&) = delete;
+	fcyTextTable& operator=(const fcyTextTable&) = delete;
+};
+/// @}
@@ -0,0 +1,44 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+/// @file  fcyTest.h
+/// @brief fcylib单元测试
+/// @note  用法：fcyTest [套件名...]，不指定时运行全部套件
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <vector>
+
+namespace fcyTest
+{
+	typedef void (*TestFunc)();
+
+	/// @brief 测试用例
+	struct TestCase
+	{
+		const char* Suite;  ///< @brief 套件名
+		const char* Name;   ///< @brief 用例名
+		TestFunc Func;      ///< @brief 测试函数
+	};
+
+	/// @brief 获得已注册的用例
+	std::vector<TestCase>& GetTests();
+
+	/// @brief 记录一次检查失败
+	void ReportFailure(const char* Expr, const char* File, int Line);
+
+	/// @brief 静态注册辅助
+	struct Registrar
+	{
+		Registrar(const char* Suite, const char* Name, TestFunc Func)
+		{
+			GetTests().push_back(TestCase { Suite, Name, Func });
+		}
+	};
+}
+
+/// @brief 定义测试用例
+#define FCY_TEST(Suite, Name) \
+	static void fcyTest_##Suite##_##Name(); \
+	static fcyTest::Registrar s_fcyTestRegistrar_##Suite##_##Name(#Suite, #Name, &fcyTest_##Suite##_##Name); \
+	static void fcyTest_##Suite##_##Name()
+
+/// @brief 检查条件，失败时记录并继续执行
+#define FCY_CHECK(Expr) ((Expr) ? (void)0 : fcyTest::ReportFailure(#Expr, __FILE__, __LINE__))
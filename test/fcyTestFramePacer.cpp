@@ -0,0 +1,55 @@
+﻿#include "fcyTest.h"
+#include "fcyMisc/fcyFramePacer.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+FCY_TEST(pacer, OnTime)
+{
+	fcyFramePacer tPacer(100.);
+	FCY_CHECK(tPacer.GetFixedDelta() > 0.0099 && tPacer.GetFixedDelta() < 0.0101);
+
+	FCY_CHECK(tPacer.WaitForNextFrame() == 1);
+	for (int i = 0; i < 9; ++i)
+		FCY_CHECK(tPacer.WaitForNextFrame() >= 1);
+	FCY_CHECK(tPacer.GetFrameCount() == 10);
+	FCY_CHECK(tPacer.GetFrameDelta() > 0.005);
+	FCY_CHECK(tPacer.GetSleepMargin() > 0. && tPacer.GetSleepMargin() <= tPacer.GetFixedDelta() / 2.);
+}
+
+FCY_TEST(pacer, CatchUp)
+{
+	fcyFramePacer tPacer(100.);
+	tPacer.SetMaxCatchUpSteps(10);
+	FCY_CHECK(tPacer.WaitForNextFrame() == 1);
+
+	// 落后约1.5个周期，需要追赶
+	this_thread::sleep_for(chrono::milliseconds(25));
+	uint32_t tSteps = tPacer.WaitForNextFrame();
+	FCY_CHECK(tSteps >= 2 && tSteps <= 10);
+	FCY_CHECK(tPacer.GetMissedCount() == 1);
+	FCY_CHECK(tPacer.GetDroppedStepCount() == 0);
+}
+
+FCY_TEST(pacer, DropSteps)
+{
+	fcyFramePacer tPacer(100.);
+	tPacer.SetMaxCatchUpSteps(2);
+	FCY_CHECK(tPacer.WaitForNextFrame() == 1);
+
+	// 落后5个周期以上，超过上限的步数被丢弃并重新对齐
+	this_thread::sleep_for(chrono::milliseconds(60));
+	FCY_CHECK(tPacer.WaitForNextFrame() == 2);
+	FCY_CHECK(tPacer.GetMissedCount() == 1);
+	FCY_CHECK(tPacer.GetDroppedStepCount() >= 3);
+
+	FCY_CHECK(tPacer.WaitForNextFrame() == 1);
+	FCY_CHECK(tPacer.GetMissedCount() == 1);
+
+	tPacer.Reset();
+	FCY_CHECK(tPacer.GetFrameCount() == 0 && tPacer.GetMissedCount() == 0 && tPacer.GetDroppedStepCount() == 0);
+}
@@ -0,0 +1,139 @@
+﻿#include "fcyTest.h"
+#include "fcyMisc/fcyHistogram.h"
+
+#include <cstdint>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	void WriteVarUInt(vector<uint8_t>& Out, uint64_t Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.push_back((uint8_t)(Value | 0x80));
+			Value >>= 7;
+		}
+		Out.push_back((uint8_t)Value);
+	}
+}
+
+FCY_TEST(histogram, Percentiles)
+{
+	fcyHdrHistogram tHist;
+	FCY_CHECK(tHist.GetTotalCount() == 0 && tHist.GetMin() == 0 && tHist.GetValueAtPercentile(50.) == 0);
+
+	for (uint64_t i = 1; i <= 100000; ++i)
+		tHist.Record(i * 1000);
+	FCY_CHECK(tHist.GetTotalCount() == 100000);
+	FCY_CHECK(tHist.GetMin() == 1000 && tHist.GetMax() == 100000000);
+	FCY_CHECK(tHist.GetMean() == 50000500.);
+	FCY_CHECK(tHist.GetValueAtPercentile(100.) == tHist.GetMax());
+
+	// 3位有效数字，误差不超过0.1%
+	uint64_t tP50 = tHist.GetValueAtPercentile(50.);
+	uint64_t tP99 = tHist.GetValueAtPercentile(99.);
+	FCY_CHECK(tP50 >= 50000000 && tP50 <= 50050000);
+	FCY_CHECK(tP99 >= 99000000 && tP99 <= 99100000);
+	FCY_CHECK(tHist.GetValueAtPercentile(0.) == 1000);
+}
+
+FCY_TEST(histogram, Saturation)
+{
+	fcyHdrHistogram tHist(1000000, 2);
+	FCY_CHECK(tHist.Record(10));
+	FCY_CHECK(!tHist.Record(5000000));
+	FCY_CHECK(tHist.GetSaturatedCount() == 1 && tHist.GetTotalCount() == 2);
+	FCY_CHECK(tHist.GetMax() == 1000000);
+	FCY_CHECK(tHist.RecordSeconds(1e-6) && tHist.GetMin() == 10);
+}
+
+FCY_TEST(histogram, MergeSameConfig)
+{
+	fcyHdrHistogram a, b;
+	a.RecordValues(1000, 10);
+	b.RecordValues(3000, 10);
+	b.Record(7);
+	a.Merge(b);
+	FCY_CHECK(a.GetTotalCount() == 21);
+	FCY_CHECK(a.GetMin() == 7 && a.GetMax() == 3000);
+	FCY_CHECK(a.GetMean() == (10000. + 30000. + 7.) / 21.);
+}
+
+FCY_TEST(histogram, MergeCrossConfig)
+{
+	// 单个样本从2位精度合并到3位精度时保留精确的最值与平均值
+	fcyHdrHistogram a(1000000, 2), b;
+	a.Record(500000);
+	b.Merge(a);
+	FCY_CHECK(b.GetTotalCount() == 1);
+	FCY_CHECK(b.GetMin() == 500000 && b.GetMax() == 500000);
+	FCY_CHECK(b.GetValueAtPercentile(100.) == 500000);
+	FCY_CHECK(b.GetMean() == 500000.);
+
+	// 合并到更小的范围时超出部分计为截断
+	fcyHdrHistogram c;
+	c.Record(100);
+	c.Record(2000000);
+	fcyHdrHistogram d(1000000, 2);
+	d.Merge(c);
+	FCY_CHECK(d.GetTotalCount() == 2 && d.GetSaturatedCount() == 1);
+	FCY_CHECK(d.GetMin() == 100 && d.GetMax() == 1000000);
+
+	// 截断计数不重复计入
+	fcyHdrHistogram e(1000000, 2);
+	e.Record(5000000);
+	fcyHdrHistogram f;
+	f.Merge(e);
+	FCY_CHECK(f.GetTotalCount() == 1 && f.GetSaturatedCount() == 1);
+}
+
+FCY_TEST(histogram, Serialize)
+{
+	fcyHdrHistogram tHist;
+	for (uint64_t i = 1; i <= 10000; ++i)
+		tHist.Record(i * 1000);
+	tHist.Record(UINT64_MAX);
+
+	vector<uint8_t> tData;
+	tHist.Serialize(tData);
+	FCY_CHECK(tData.size() < tHist.GetMemorySize() / 4);
+
+	fcyHdrHistogram tLoaded(1000, 1);
+	FCY_CHECK(tLoaded.Deserialize(tData.data(), tData.size()));
+	FCY_CHECK(tLoaded.GetHighestTrackableValue() == tHist.GetHighestTrackableValue());
+	FCY_CHECK(tLoaded.GetSignificantDigits() == tHist.GetSignificantDigits());
+	FCY_CHECK(tLoaded.GetTotalCount() == tHist.GetTotalCount());
+	FCY_CHECK(tLoaded.GetSaturatedCount() == 1);
+	FCY_CHECK(tLoaded.GetMin() == tHist.GetMin() && tLoaded.GetMax() == tHist.GetMax());
+	FCY_CHECK(tLoaded.GetMean() == tHist.GetMean());
+	for (double p : { 1., 50., 90., 99., 99.99, 100. })
+		FCY_CHECK(tLoaded.GetValueAtPercentile(p) == tHist.GetValueAtPercentile(p));
+
+	// 截断的数据不被接受，且不改变当前内容
+	FCY_CHECK(!tLoaded.Deserialize(tData.data(), tData.size() / 2));
+	FCY_CHECK(!tLoaded.Deserialize(nullptr, 0));
+	FCY_CHECK(tLoaded.GetTotalCount() == tHist.GetTotalCount());
+}
+
+FCY_TEST(histogram, DeserializeVersion1)
+{
+	// 版本1不含总和：magic, 版本, 范围, 精度, 截断数, 最小, 最大, 长度, 计数编码
+	vector<uint8_t> tData;
+	for (uint64_t v : { 0x52444846ull, 1ull, 1000000ull, 2ull, 0ull, 10ull, 10ull, 11ull, 20ull, 7ull })
+		WriteVarUInt(tData, v);
+
+	fcyHdrHistogram tHist;
+	FCY_CHECK(tHist.Deserialize(tData.data(), tData.size()));
+	FCY_CHECK(tHist.GetHighestTrackableValue() == 1000000 && tHist.GetSignificantDigits() == 2);
+	FCY_CHECK(tHist.GetTotalCount() == 3);
+	FCY_CHECK(tHist.GetMin() == 10 && tHist.GetMax() == 10);
+	FCY_CHECK(tHist.GetMean() == 10.);
+
+	// 未知版本
+	tData[5] = 9;  // magic占5字节
+	fcyHdrHistogram tOther;
+	FCY_CHECK(!tOther.Deserialize(tData.data(), tData.size()));
+}
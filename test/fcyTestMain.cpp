@@ -0,0 +1,63 @@
+﻿#include "fcyTest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	uint32_t g_Failures = 0;
+}
+
+vector<fcyTest::TestCase>& fcyTest::GetTests()
+{
+	static vector<TestCase> s_Tests;
+	return s_Tests;
+}
+
+void fcyTest::ReportFailure(const char* Expr, const char* File, int Line)
+{
+	fprintf(stderr, "%s:%d: check failed: %s\n", File, Line, Expr);
+	++g_Failures;
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t tRun = 0, tFailed = 0;
+	for (int a = 1; a <= argc; ++a)
+	{
+		// 不带参数时运行全部套件
+		const char* tSuite = a < argc ? argv[a] : nullptr;
+		if (!tSuite && argc > 1)
+			break;
+
+		uint32_t tMatched = 0;
+		for (auto& t : fcyTest::GetTests())
+		{
+			if (tSuite && strcmp(t.Suite, tSuite) != 0)
+				continue;
+			++tMatched;
+			++tRun;
+
+			uint32_t tBefore = g_Failures;
+			t.Func();
+			bool tOK = g_Failures == tBefore;
+			if (!tOK)
+				++tFailed;
+			printf("[%s] %s %s\n", t.Suite, t.Name, tOK ? "ok" : "FAILED");
+		}
+
+		if (tSuite && tMatched == 0)
+		{
+			fprintf(stderr, "unknown suite: %s\n", tSuite);
+			return 2;
+		}
+	}
+
+	printf("%u test(s), %u failed\n", tRun, tFailed);
+	return tFailed == 0 ? 0 : 1;
+}
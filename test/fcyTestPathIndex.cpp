@@ -0,0 +1,193 @@
+﻿#include "fcyTest.h"
+#include "fcyParser/fcyPathIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	void AddSample(fcyPathIndex& Index)
+	{
+		Index.Add("image/boss/stage1.png", 1);
+		Index.Add("image/boss/Stage2.PNG", 2);
+		Index.Add("image/boss/st.txt", 3);
+		Index.Add("image/boss/big.png", 4);
+		Index.Add("image/ui/button.png", 5);
+		Index.Add("image\\ui\\deep\\icon.png", 6);
+		Index.Add("image/bg.jpg", 7);
+		Index.Add("sound/bgm.ogg", 8);
+		Index.Add("readme.txt", 9);
+		Index.Build();
+	}
+
+	// 转为排序后的完整路径，便于比较
+	vector<string> ToPaths(const fcyPathIndex& Index, const vector<uint32_t>& Nodes)
+	{
+		vector<string> tRet;
+		for (uint32_t i : Nodes)
+			tRet.push_back(Index.GetFullPath(i));
+		sort(tRet.begin(), tRet.end());
+		return tRet;
+	}
+
+	vector<string> Glob(const fcyPathIndex& Index, const char* Pattern)
+	{
+		vector<uint32_t> tOut;
+		Index.Glob(Pattern, tOut);
+		return ToPaths(Index, tOut);
+	}
+
+	vector<string> QueryPrefix(const fcyPathIndex& Index, const char* Prefix)
+	{
+		vector<uint32_t> tOut;
+		Index.QueryPrefix(Prefix, tOut);
+		return ToPaths(Index, tOut);
+	}
+
+	// 对同一索引执行所有查询检查，用于构建结果与附加映像的比较
+	void CheckQueries(const fcyPathIndex& Index)
+	{
+		uint32_t tValue = 0;
+		FCY_CHECK(Index.FindValue("Image/Boss/STAGE2.png", tValue) && tValue == 2);
+		FCY_CHECK(Index.FindValue("image/ui/../ui/deep/icon.png", tValue) && tValue == 6);
+		FCY_CHECK(!Index.FindValue("image/boss", tValue));
+		FCY_CHECK(!Index.FindValue("image/boss/none.png", tValue));
+		uint32_t tBoss = Index.Find("image/boss/");
+		FCY_CHECK(tBoss != fcyPathIndex::InvalidNode && Index.IsDirectory(tBoss) && !Index.IsFile(tBoss));
+		FCY_CHECK(Index.GetName(tBoss) == "boss" && Index.GetFullPath(Index.GetParent(tBoss)) == "image");
+
+		// 列目录按名称排序，包含子目录
+		vector<uint32_t> tOut;
+		Index.ListDirectory("image", tOut);
+		FCY_CHECK(tOut.size() == 3);
+		if (tOut.size() == 3)
+		{
+			FCY_CHECK(Index.GetName(tOut[0]) == "bg.jpg" && Index.GetName(tOut[1]) == "boss" && Index.GetName(tOut[2]) == "ui");
+		}
+		tOut.clear();
+		Index.ListDirectory("", tOut);
+		FCY_CHECK(tOut.size() == 3 && Index.GetName(tOut[1]) == "readme.txt");
+
+		// 目录前缀与名称前缀
+		FCY_CHECK(QueryPrefix(Index, "image/boss/").size() == 4);
+		FCY_CHECK(QueryPrefix(Index, "image/boss/st") == vector<string>({
+			"image\\boss\\st.txt", "image\\boss\\stage1.png", "image\\boss\\stage2.png" }));
+		FCY_CHECK(QueryPrefix(Index, "image/u") == vector<string>({
+			"image\\ui\\button.png", "image\\ui\\deep\\icon.png" }));
+		FCY_CHECK(QueryPrefix(Index, "image/boss/stx").empty());
+		FCY_CHECK(QueryPrefix(Index, "").size() == 9);
+
+		// 后缀
+		tOut.clear();
+		Index.QueryExtension("image", "PNG", true, tOut);
+		FCY_CHECK(tOut.size() == 5);
+		tOut.clear();
+		Index.QueryExtension("image/boss", ".png", false, tOut);
+		FCY_CHECK(tOut.size() == 3);
+		tOut.clear();
+		Index.QueryExtension("", "txt", false, tOut);
+		FCY_CHECK(ToPaths(Index, tOut) == vector<string>({ "readme.txt" }));
+
+		// 末尾的"**"
+		FCY_CHECK(Glob(Index, "image/**").size() == 7);
+		FCY_CHECK(Glob(Index, "**").size() == 9);
+		FCY_CHECK(Glob(Index, "image/ui/**") == vector<string>({
+			"image\\ui\\button.png", "image\\ui\\deep\\icon.png" }));
+
+		// 中间的"**"匹配零层或多层目录
+		FCY_CHECK(Glob(Index, "image/**/*.png").size() == 5);
+		FCY_CHECK(Glob(Index, "**/*.ogg") == vector<string>({ "sound\\bgm.ogg" }));
+		FCY_CHECK(Glob(Index, "image/**/deep/*") == vector<string>({ "image\\ui\\deep\\icon.png" }));
+		FCY_CHECK(Glob(Index, "**/ui/**") == vector<string>({
+			"image\\ui\\button.png", "image\\ui\\deep\\icon.png" }));
+
+		// 段内的'?'与'*'
+		FCY_CHECK(Glob(Index, "image/boss/stage?.png") == vector<string>({
+			"image\\boss\\stage1.png", "image\\boss\\stage2.png" }));
+		FCY_CHECK(Glob(Index, "image/b*/*.txt") == vector<string>({ "image\\boss\\st.txt" }));
+		FCY_CHECK(Glob(Index, "image/*/b*") == vector<string>({
+			"image\\boss\\big.png", "image\\ui\\button.png" }));
+		FCY_CHECK(Glob(Index, "image/boss/?.txt").empty());
+		FCY_CHECK(Glob(Index, "image/boss").empty());
+	}
+}
+
+FCY_TEST(pathindex, Build)
+{
+	fcyPathIndex tIndex;
+	AddSample(tIndex);
+	FCY_CHECK(tIndex.GetNodeCount() == 15);
+	CheckQueries(tIndex);
+
+	// 重复添加时覆盖，空路径无效
+	FCY_CHECK(tIndex.Add("image/bg.jpg", 70));
+	FCY_CHECK(!tIndex.Add("", 1));
+	tIndex.Build();
+	uint32_t tValue = 0;
+	FCY_CHECK(tIndex.FindValue("image/bg.jpg", tValue) && tValue == 70);
+	FCY_CHECK(tIndex.GetNodeCount() == 15);
+}
+
+FCY_TEST(pathindex, AttachRoundTrip)
+{
+	fcyPathIndex tSource;
+	AddSample(tSource);
+
+	// 保存映像到4字节对齐的缓冲区，模拟内存映射的文件
+	size_t tSize = tSource.GetImageSize();
+	vector<uint32_t> tSaved((tSize + 3) / 4);
+	memcpy(tSaved.data(), tSource.GetImageData(), tSize);
+	tSource.Clear();
+
+	fcyPathIndex tIndex;
+	FCY_CHECK(tIndex.Attach(tSaved.data(), tSize));
+	FCY_CHECK(tIndex.GetImageData() == tSaved.data() && tIndex.GetImageSize() == tSize);
+	CheckQueries(tIndex);
+
+	// 附加后只读，Build不改变映像
+	FCY_CHECK(!tIndex.Add("new.png", 1));
+	tIndex.Build();
+	FCY_CHECK(tIndex.GetImageData() == tSaved.data());
+
+	// 截断、损坏或未对齐的映像被拒绝，不影响当前映像
+	fcyPathIndex tBad;
+	FCY_CHECK(!tBad.Attach(tSaved.data(), tSize - 4));
+	FCY_CHECK(!tBad.Attach((const uint8_t*)tSaved.data() + 2, tSize - 2));
+	vector<uint32_t> tCorrupt = tSaved;
+	tCorrupt[0] ^= 1;
+	FCY_CHECK(!tBad.Attach(tCorrupt.data(), tSize));
+	FCY_CHECK(tBad.GetNodeCount() == 1);
+}
+
+FCY_TEST(pathindex, LoadReadOnly)
+{
+	fcyPathIndex tIndex;
+	{
+		fcyPathIndex tSource;
+		AddSample(tSource);
+
+		// 从未对齐的副本加载
+		vector<uint8_t> tBytes(tSource.GetImageSize() + 1);
+		memcpy(tBytes.data() + 1, tSource.GetImageData(), tSource.GetImageSize());
+		FCY_CHECK(tIndex.Load(tBytes.data() + 1, tSource.GetImageSize()));
+	}
+	CheckQueries(tIndex);
+
+	FCY_CHECK(!tIndex.Add("new.png", 1));
+	tIndex.Build();
+	FCY_CHECK(tIndex.Find("new.png") == fcyPathIndex::InvalidNode);
+
+	// Clear后可以重新添加
+	tIndex.Clear();
+	FCY_CHECK(tIndex.GetNodeCount() == 1);
+	FCY_CHECK(tIndex.Add("new.png", 1));
+	tIndex.Build();
+	uint32_t tValue = 0;
+	FCY_CHECK(tIndex.FindValue("new.png", tValue) && tValue == 1);
+}
@@ -0,0 +1,97 @@
+﻿#include "fcyTest.h"
+#include "fcyParser/fcyPathParser.h"
+#include "fcyParser/fcyPathCache.h"
+
+#include <thread>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+FCY_TEST(path, PathView)
+{
+	fcyPathParser::PathView a("image|boss/st01\\a.tar.PNG");
+	FCY_CHECK(a.GetDirectory() == "image|boss/st01\\");
+	FCY_CHECK(a.GetFileName() == "a.tar.PNG");
+	FCY_CHECK(a.GetStem() == "a.tar");
+	FCY_CHECK(a.GetExtension() == "PNG" && a.HasExtension());
+
+	fcyPathParser::PathView b("a.b|c");
+	FCY_CHECK(b.GetDirectory() == "a.b|" && b.GetFileName() == "c" && !b.HasExtension() && b.GetStem() == "c");
+
+	fcyPathParser::PathView c("dir/");
+	FCY_CHECK(c.GetDirectory() == "dir/" && c.GetFileName().empty());
+
+	fcyPathParser::PathView d(".hidden");
+	FCY_CHECK(d.GetStem().empty() && d.GetExtension() == "hidden");
+
+	fcyPathParser::WPathView w(L"a\\b|c.txt");
+	FCY_CHECK(w.GetFileName() == L"c.txt" && w.GetExtension() == L"txt");
+}
+
+FCY_TEST(path, LegacyGetters)
+{
+	// 只含'\\'的路径与原实现结果一致
+	FCY_CHECK(fcyPathParser::GetExtension("image\\boss\\a.PNG") == "PNG");
+	FCY_CHECK(fcyPathParser::GetExtensionLower("image\\boss\\a.PNG") == "png");
+	FCY_CHECK(fcyPathParser::GetFileName("image\\boss\\a.PNG") == "a.PNG");
+	FCY_CHECK(fcyPathParser::GetFileNameWithoutExt("image\\boss\\a.PNG") == "a");
+	FCY_CHECK(fcyPathParser::GetPath("image\\boss\\a.PNG") == "image\\boss\\");
+	FCY_CHECK(fcyPathParser::GetExtension("noext") == "noext");
+	FCY_CHECK(fcyPathParser::GetPath("x.png") == "x.png\\");
+	FCY_CHECK(fcyPathParser::GetPath("") == "");
+	FCY_CHECK(fcyPathParser::GetFileNameWithoutExt(".hidden") == "");
+
+	// '/'与'|'分隔的路径
+	FCY_CHECK(fcyPathParser::GetFileName("image/boss/a.png") == "a.png");
+	FCY_CHECK(fcyPathParser::GetFileName("a|b|c.tar.gz") == "c.tar.gz");
+	FCY_CHECK(fcyPathParser::GetPath("a|b|c.tar.gz") == "a\\b\\");
+	FCY_CHECK(fcyPathParser::GetExtension(wstring(L"a/b.Lua")) == L"Lua");
+}
+
+FCY_TEST(path, Normalize)
+{
+	FCY_CHECK(fcyPathParser::Normalize("Image/./Boss/../A.PNG") == "image\\a.png");
+	FCY_CHECK(fcyPathParser::Normalize("a//b|c/") == "a\\b\\c");
+	FCY_CHECK(fcyPathParser::Normalize("a/../../x") == "..\\x");
+	FCY_CHECK(fcyPathParser::Normalize("../../x/..") == "..\\..");
+	FCY_CHECK(fcyPathParser::Normalize("/../x") == "\\x");
+	FCY_CHECK(fcyPathParser::Normalize("./") == "");
+	FCY_CHECK(fcyPathParser::Normalize("C:/../x") == "c:\\x");
+	FCY_CHECK(fcyPathParser::Normalize("C:\\a\\..\\..\\B") == "c:\\b");
+	FCY_CHECK(fcyPathParser::Normalize("d:../x") == "d:..\\x");
+	FCY_CHECK(fcyPathParser::Normalize("D:") == "d:");
+}
+
+FCY_TEST(path, PathCache)
+{
+	fcyPathCache tCache;
+	uint32_t a = tCache.GetID("Image/Boss/a.png");
+	FCY_CHECK(a != fcyPathCache::InvalidID);
+	FCY_CHECK(tCache.GetID("image\\boss\\./A.PNG") == a);
+	FCY_CHECK(tCache.GetID("image/x/../boss/a.png") == a);
+	FCY_CHECK(tCache.GetID("C:/../image/boss/a.png") != a);
+	FCY_CHECK(tCache.GetCanonicalPath(a) == "image\\boss\\a.png");
+	FCY_CHECK(tCache.FindID("IMAGE/BOSS/A.PNG") == fcyPathCache::InvalidID);
+	FCY_CHECK(tCache.FindID("image\\boss\\./A.PNG") == a);
+	FCY_CHECK(tCache.GetCanonicalCount() == 2 && tCache.GetRawCount() == 4);
+
+	// 并发插入同一组路径得到相同ID
+	vector<thread> tThreads;
+	vector<uint32_t> tIDs(4);
+	for (uint32_t t = 0; t < 4; ++t)
+	{
+		tThreads.emplace_back([&, t]() {
+			for (int i = 0; i < 1000; ++i)
+				tCache.GetID("stage/" + to_string(i) + (t & 1 ? "/X.lua" : "\\x.LUA"));
+			tIDs[t] = tCache.GetID("stage/7/x.lua");
+		});
+	}
+	for (auto& t : tThreads)
+		t.join();
+	FCY_CHECK(tIDs[0] == tIDs[1] && tIDs[1] == tIDs[2] && tIDs[2] == tIDs[3]);
+	FCY_CHECK(tCache.GetCanonicalCount() == 1002);
+
+	tCache.Clear();
+	FCY_CHECK(tCache.GetCanonicalCount() == 0 && tCache.GetRawCount() == 0);
+}
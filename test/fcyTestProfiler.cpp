@@ -0,0 +1,143 @@
+﻿#include "fcyTest.h"
+#include "fcyMisc/fcyProfiler.h"
+#include "fcyMisc/fcyStopWatch.h"
+
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	void Spin(double Seconds)
+	{
+		fcyStopWatch tWatch;
+		while (tWatch.GetElapsed() < Seconds)
+		{
+		}
+	}
+
+	const fcyProfiler::ZoneStat* FindStat(const char* Name)
+	{
+		for (auto& i : fcyProfiler::GetInstance().GetFrameStats())
+		{
+			if (strcmp(i.Name, Name) == 0)
+				return &i;
+		}
+		return nullptr;
+	}
+
+	size_t CountOf(const string& Str, const string& Sub)
+	{
+		size_t tRet = 0;
+		for (size_t i = Str.find(Sub); i != string::npos; i = Str.find(Sub, i + 1))
+			++tRet;
+		return tRet;
+	}
+}
+
+FCY_TEST(profiler, SelfTime)
+{
+	fcyProfiler& tProfiler = fcyProfiler::GetInstance();
+	tProfiler.EndFrame();
+
+	fcyProfiler::BeginZone("test_outer");
+	Spin(0.002);
+	for (int i = 0; i < 3; ++i)
+	{
+		fcyProfileZone tZone("test_inner");
+		Spin(0.001);
+	}
+	fcyProfiler::EndZone();
+	tProfiler.EndFrame();
+
+	const fcyProfiler::ZoneStat* pOuter = FindStat("test_outer");
+	const fcyProfiler::ZoneStat* pInner = FindStat("test_inner");
+	FCY_CHECK(pOuter && pInner);
+	if (!pOuter || !pInner)
+		return;
+	FCY_CHECK(pOuter->Count == 1 && pInner->Count == 3);
+	FCY_CHECK(pInner->SelfTicks == pInner->TotalTicks);
+	FCY_CHECK(pOuter->TotalTicks > pInner->TotalTicks);
+	FCY_CHECK(pOuter->SelfTicks == pOuter->TotalTicks - pInner->TotalTicks);
+	FCY_CHECK(fcyStopWatch::TicksToSeconds(pInner->TotalTicks) >= 0.003);
+	FCY_CHECK(fcyStopWatch::TicksToSeconds(pOuter->SelfTicks) >= 0.002);
+
+	// 下一帧没有新区段
+	tProfiler.EndFrame();
+	FCY_CHECK(FindStat("test_outer") == nullptr);
+}
+
+FCY_TEST(profiler, ShortLivedThreads)
+{
+	fcyProfiler& tProfiler = fcyProfiler::GetInstance();
+	tProfiler.EndFrame();
+	uint64_t tDropped = tProfiler.GetDroppedCount();
+
+	for (int i = 0; i < 50; ++i)
+	{
+		thread t([]() {
+			fcyProfileZone tZone("test_worker");
+		});
+		t.join();
+		tProfiler.EndFrame();
+
+		const fcyProfiler::ZoneStat* p = FindStat("test_worker");
+		FCY_CHECK(p && p->Count == 1);
+	}
+	FCY_CHECK(tProfiler.GetDroppedCount() == tDropped);
+}
+
+FCY_TEST(profiler, ChromeTrace)
+{
+	fcyProfiler& tProfiler = fcyProfiler::GetInstance();
+	tProfiler.SetThreadName("test \"main\"");
+	tProfiler.EndFrame();
+
+	// 跨越录制开始的区段完整导出，录制结束时未结束的区段不导出
+	fcyProfiler::BeginZone("test_before");
+	tProfiler.BeginCapture();
+	{
+		fcyProfileZone a("test_a");
+		fcyProfileZone b("test_b");
+	}
+	fcyProfiler::EndZone();
+	fcyProfiler::BeginZone("test_open");
+	tProfiler.EndFrame();
+	tProfiler.EndCapture();
+
+	ostringstream tOut;
+	tProfiler.ExportChromeTrace(tOut);
+	string tJson = tOut.str();
+	FCY_CHECK(CountOf(tJson, "\"ph\":\"X\"") == 3);
+	FCY_CHECK(CountOf(tJson, "\"ph\":\"B\"") == 0 && CountOf(tJson, "\"ph\":\"E\"") == 0);
+	FCY_CHECK(CountOf(tJson, "\"test_before\"") == 1);
+	FCY_CHECK(CountOf(tJson, "\"test_a\"") == 1 && CountOf(tJson, "\"test_b\"") == 1);
+	FCY_CHECK(CountOf(tJson, "test_open") == 0);
+	FCY_CHECK(CountOf(tJson, "\"test \\\"main\\\"\"") == 1);
+	FCY_CHECK(tJson.front() == '{' && tJson.find("]}") != string::npos);
+
+	fcyProfiler::EndZone();
+	tProfiler.EndFrame();
+}
+
+FCY_TEST(profiler, CaptureLimit)
+{
+	fcyProfiler& tProfiler = fcyProfiler::GetInstance();
+	tProfiler.EndFrame();
+
+	tProfiler.BeginCapture(2);
+	fcyProfiler::BeginZone("test_limit_outer");
+	for (int i = 0; i < 5; ++i)
+		fcyProfileZone tZone("test_limit");
+	fcyProfiler::EndZone();
+	tProfiler.EndFrame();
+
+	ostringstream tOut;
+	tProfiler.ExportChromeTrace(tOut);
+	FCY_CHECK(CountOf(tOut.str(), "\"ph\":\"X\"") == 2);
+	FCY_CHECK(CountOf(tOut.str(), "\"ph\":\"B\"") == 0);
+}
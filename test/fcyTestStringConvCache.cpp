@@ -0,0 +1,96 @@
+﻿#include "fcyTest.h"
+#include "fcyMisc/fcyStringConvCache.h"
+#include "fcyMisc/fcyStringHelper.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+FCY_TEST(convcache, HitAndMiss)
+{
+	fcyStringConvCache tCache;
+	const string tSrc = "image/\xE4\xB8\xAD\xE6\x96\x87.png";
+
+	fcyStringConvCache::WStringPtr a = tCache.MultiByteToWideChar_UTF8(tSrc);
+	fcyStringConvCache::WStringPtr b = tCache.MultiByteToWideChar_UTF8(tSrc);
+	FCY_CHECK(a && *a == fcyStringHelper::MultiByteToWideChar_UTF8(tSrc));
+	FCY_CHECK(a == b);
+
+	// 非法序列与空串的结果与直接转换相同
+	const string tBad = "\xC0\xAF";
+	FCY_CHECK(*tCache.MultiByteToWideChar_UTF8(tBad) == fcyStringHelper::MultiByteToWideChar_UTF8(tBad));
+	FCY_CHECK(tCache.MultiByteToWideChar_UTF8("")->empty());
+
+	fcyStringConvCache::Stats tStats = tCache.GetStats();
+	FCY_CHECK(tStats.Hits == 1 && tStats.Misses == 3);
+	FCY_CHECK(tStats.EntryCount == 3 && tStats.Bytes > 0);
+
+	tCache.ResetStats();
+	tStats = tCache.GetStats();
+	FCY_CHECK(tStats.Hits == 0 && tStats.Misses == 0 && tStats.EntryCount == 3);
+}
+
+FCY_TEST(convcache, Budget)
+{
+	fcyStringConvCache tCache(16 * 1024);
+	FCY_CHECK(tCache.GetByteBudget() == 16 * 1024);
+
+	for (int i = 0; i < 2000; ++i)
+		tCache.MultiByteToWideChar_UTF8("key_" + to_string(i));
+	fcyStringConvCache::Stats tStats = tCache.GetStats();
+	FCY_CHECK(tStats.Evictions > 0);
+	FCY_CHECK(tStats.Bytes <= tStats.ByteBudget);
+	FCY_CHECK(tStats.EntryCount < 2000);
+
+	// 超出分片预算的字符串不缓存，但仍返回正确结果
+	string tLong(4096, 'x');
+	FCY_CHECK(*tCache.MultiByteToWideChar_UTF8(tLong) == wstring(4096, L'x'));
+	FCY_CHECK(tCache.GetStats().Bypasses == 1);
+
+	// 缩小预算立即淘汰
+	tCache.SetByteBudget(4 * 1024);
+	tStats = tCache.GetStats();
+	FCY_CHECK(tStats.Bytes <= 4 * 1024 && tStats.ByteBudget == 4 * 1024);
+}
+
+FCY_TEST(convcache, ClearKeepsResults)
+{
+	fcyStringConvCache tCache;
+	fcyStringConvCache::WStringPtr a = tCache.MultiByteToWideChar_UTF8("keep");
+	tCache.Clear();
+	FCY_CHECK(tCache.GetStats().EntryCount == 0 && tCache.GetStats().Bytes == 0);
+	FCY_CHECK(*a == L"keep");
+
+	fcyStringConvCache::WStringPtr b = tCache.MultiByteToWideChar_UTF8("keep");
+	FCY_CHECK(*b == L"keep" && a != b);
+}
+
+FCY_TEST(convcache, Concurrent)
+{
+	fcyStringConvCache tCache(64 * 1024);
+	vector<thread> tThreads;
+	vector<int> tOk(4, 1);
+	for (int t = 0; t < 4; ++t)
+	{
+		tThreads.emplace_back([&tCache, &tOk, t]() {
+			for (int i = 0; i < 5000; ++i)
+			{
+				string tKey = "k" + to_string((i * 7 + t) % 300);
+				if (*tCache.MultiByteToWideChar_UTF8(tKey) != wstring(tKey.begin(), tKey.end()))
+					tOk[t] = 0;
+			}
+		});
+	}
+	for (thread& t : tThreads)
+		t.join();
+
+	for (int i : tOk)
+		FCY_CHECK(i == 1);
+	fcyStringConvCache::Stats tStats = tCache.GetStats();
+	FCY_CHECK(tStats.Hits + tStats.Misses == 20000);
+	FCY_CHECK(tStats.Bytes <= tStats.ByteBudget);
+}
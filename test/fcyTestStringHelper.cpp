@@ -0,0 +1,157 @@
+﻿#include "fcyTest.h"
+#include "fcyMisc/fcyStringHelper.h"
+
+#include <string>
+#include <unordered_set>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	int Sign(int Value)
+	{
+		return (Value > 0) - (Value < 0);
+	}
+}
+
+FCY_TEST(string, SplitAndTrim)
+{
+	vector<string> tSplit;
+	vector<string_view> tView;
+	fcyStringHelper::StringSplit(" a, b ,,c ", ",", false, tSplit);
+	fcyStringHelper::StringSplitView(" a, b ,,c ", ",", false, tView);
+	FCY_CHECK(tSplit.size() == 4 && tView.size() == 4);
+	for (size_t i = 0; i < tSplit.size() && i < tView.size(); ++i)
+		FCY_CHECK(tSplit[i] == tView[i]);
+
+	fcyStringHelper::StringSplitView("a,,b,", ",", true, tView);
+	FCY_CHECK(tView.size() == 2 && tView[0] == "a" && tView[1] == "b");
+	fcyStringHelper::StringSplitView("abc", "", false, tView);
+	FCY_CHECK(tView.size() == 1 && tView[0] == "abc");
+
+	FCY_CHECK(fcyStringHelper::TrimView(" \t x y \r\n") == "x y");
+	FCY_CHECK(fcyStringHelper::TrimLeftView("  x ") == "x ");
+	FCY_CHECK(fcyStringHelper::TrimRightView("  x ") == "  x");
+	FCY_CHECK(fcyStringHelper::TrimView(" \t ").empty());
+	FCY_CHECK(fcyStringHelper::Trim(string(" x ")) == "x");
+}
+
+FCY_TEST(string, ToLower)
+{
+	// 覆盖SIMD主循环与尾部
+	string tStr = "Image/BOSS/Stage_01/ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]@`\xC3\x80.PNG";
+	string tExpect;
+	for (char c : tStr)
+		tExpect += (c >= 'A' && c <= 'Z') ? char(c + 32) : c;
+	FCY_CHECK(fcyStringHelper::ToLower(tStr) == tExpect);
+	fcyStringHelper::ToLowerInPlace(tStr);
+	FCY_CHECK(tStr == tExpect);
+}
+
+FCY_TEST(string, CompareNoCase)
+{
+	FCY_CHECK(fcyStringHelper::CompareNoCase("ABC", "abc") == 0);
+	FCY_CHECK(fcyStringHelper::CompareNoCase("apple", "Banana") < 0);
+	FCY_CHECK(fcyStringHelper::CompareNoCase("ab", "ABC") < 0);
+	FCY_CHECK(fcyStringHelper::CompareNoCase("abc", "AB") > 0);
+	// 按小写比较：'['(0x5B)小于'a'
+	FCY_CHECK(fcyStringHelper::CompareNoCase("[", "A") < 0);
+	FCY_CHECK(fcyStringHelper::CompareNoCase("\xC3\x80", "z") > 0);
+
+	// 与小写副本的字典序一致
+	uint32_t tSeed = 12345;
+	auto tRand = [&]() { tSeed = tSeed * 1664525u + 1013904223u; return tSeed >> 8; };
+	const char tAlphabet[] = "aAbBzZ[_`\x80\xff/";
+	for (int n = 0; n < 2000; ++n)
+	{
+		string a, b;
+		size_t la = tRand() % 40, lb = tRand() % 40;
+		for (size_t i = 0; i < la; ++i)
+			a += tAlphabet[tRand() % (sizeof(tAlphabet) - 1)];
+		b = a.substr(0, min(la, lb));
+		for (size_t i = b.size(); i < lb; ++i)
+			b += tAlphabet[tRand() % (sizeof(tAlphabet) - 1)];
+		int tExpect = Sign(fcyStringHelper::ToLower(a).compare(fcyStringHelper::ToLower(b)));
+		FCY_CHECK(Sign(fcyStringHelper::CompareNoCase(a, b)) == tExpect);
+		FCY_CHECK(fcyStringHelper::EqualsNoCase(a, b) == (tExpect == 0));
+	}
+
+	FCY_CHECK(fcyStringHelper::EndsWithNoCase("image/a.PNG", ".png"));
+	FCY_CHECK(!fcyStringHelper::EndsWithNoCase("png", ".png"));
+}
+
+FCY_TEST(string, HashNoCase)
+{
+	FCY_CHECK(fcyStringHelper::HashNoCase("Image/Boss.PNG") == fcyStringHelper::HashNoCase("image/boss.png"));
+	FCY_CHECK(fcyStringHelper::HashNoCase("a.png") != fcyStringHelper::HashNoCase("b.png"));
+
+	unordered_set<string_view, fcyStringHelper::NoCaseHash, fcyStringHelper::NoCaseEqual> tSet;
+	tSet.insert("Image/A.png");
+	FCY_CHECK(tSet.count("IMAGE/a.PNG") == 1);
+	FCY_CHECK(tSet.count("image/b.png") == 0);
+}
+
+FCY_TEST(string, UTF8Iterate)
+{
+	const string tStr = "a\xE7\xAC\xAC\xF0\x9F\x98\x80\xFF";  // a 第 😀 非法字节
+	vector<char32_t> tCodes;
+	for (char32_t c : fcyStringHelper::UTF8Range(tStr))
+		tCodes.push_back(c);
+	FCY_CHECK(tCodes.size() == 4);
+	FCY_CHECK(tCodes.size() == 4 && tCodes[0] == U'a' && tCodes[1] == U'\u7B2C' && tCodes[2] == U'\U0001F600' && tCodes[3] == 0xFFFD);
+	FCY_CHECK(fcyStringHelper::UTF8Length(tStr) == 4);
+
+	// 过长编码与代理区
+	char32_t c = 0;
+	const char tOverlong[] = "\xC0\xAF";
+	FCY_CHECK(fcyStringHelper::UTF8Decode(tOverlong, tOverlong + 2, c) == 1 && c == 0xFFFD);
+	const char tSurrogate[] = "\xED\xA0\x80";
+	FCY_CHECK(fcyStringHelper::UTF8Decode(tSurrogate, tSurrogate + 3, c) == 1 && c == 0xFFFD);
+
+	// 长文本覆盖SIMD路径
+	string tLong;
+	for (int i = 0; i < 100; ++i)
+		tLong += "ab\xE7\xAC\xAC";
+	FCY_CHECK(fcyStringHelper::UTF8Length(tLong) == 300);
+}
+
+FCY_TEST(string, UTF8Offset)
+{
+	const string tStr = "a\xE7\xAC\xAC" "b";
+	FCY_CHECK(fcyStringHelper::UTF8Offset(tStr, 0) == 0);
+	FCY_CHECK(fcyStringHelper::UTF8Offset(tStr, 1) == 1);
+	FCY_CHECK(fcyStringHelper::UTF8Offset(tStr, 2) == 4);
+	FCY_CHECK(fcyStringHelper::UTF8Offset(tStr, 3) == tStr.size());
+	FCY_CHECK(fcyStringHelper::UTF8Offset(tStr, 10) == tStr.size());
+}
+
+FCY_TEST(string, UTF8Trim)
+{
+	// U+3000全角空格、U+00A0不换行空格
+	const string tStr = "\xE3\x80\x80 \t\xE7\xAC\xAC" "1 x\xC2\xA0\n";
+	FCY_CHECK(fcyStringHelper::UTF8Trim(tStr) == "\xE7\xAC\xAC" "1 x");
+	FCY_CHECK(fcyStringHelper::UTF8TrimLeft(tStr) == "\xE7\xAC\xAC" "1 x\xC2\xA0\n");
+	FCY_CHECK(fcyStringHelper::UTF8TrimRight(tStr) == "\xE3\x80\x80 \t\xE7\xAC\xAC" "1 x");
+	FCY_CHECK(fcyStringHelper::UTF8Trim("\xE3\x80\x80").empty());
+	FCY_CHECK(fcyStringHelper::UTF8IsSpace(0x3000) && fcyStringHelper::UTF8IsSpace(0xA0) && !fcyStringHelper::UTF8IsSpace(U'x'));
+}
+
+FCY_TEST(string, UTF8FoldCase)
+{
+	FCY_CHECK(fcyStringHelper::UTF8FoldCase(U'A') == U'a');
+	FCY_CHECK(fcyStringHelper::UTF8FoldCase(0xC1) == 0xE1);    // Á
+	FCY_CHECK(fcyStringHelper::UTF8FoldCase(0xD7) == 0xD7);    // ×
+	FCY_CHECK(fcyStringHelper::UTF8FoldCase(0x100) == 0x101);  // Ā
+	FCY_CHECK(fcyStringHelper::UTF8FoldCase(0x7B2C) == 0x7B2C);
+
+	string tStr = "\xC3\x80\xC3\x89X\xC4\x80\xE7\xAC\xAC\xFF";  // ÀÉXĀ第 非法字节
+	fcyStringHelper::UTF8FoldCaseInPlace(tStr);
+	FCY_CHECK(tStr == "\xC3\xA0\xC3\xA9x\xC4\x81\xE7\xAC\xAC\xFF");
+
+	FCY_CHECK(fcyStringHelper::UTF8EqualsNoCase("\xC3\x81" "BC", "\xC3\xA1" "bc"));
+	FCY_CHECK(fcyStringHelper::UTF8EqualsNoCase("\xC4\x80", "\xC4\x81"));
+	FCY_CHECK(!fcyStringHelper::UTF8EqualsNoCase("abc", "abd"));
+	FCY_CHECK(!fcyStringHelper::UTF8EqualsNoCase("abc", "ab"));
+}
@@ -0,0 +1,127 @@
+﻿#include "fcyTest.h"
+#include "fcyParser/fcyTextTable.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+
+FCY_TEST(table, Parse)
+{
+	static const char s_Text[] =
+		"\xEF\xBB\xBF" "id, name ,value\r\n"
+		"# comment\r\n"
+		"\r\n"
+		"1,alpha, 10\n"
+		"   \n"
+		"2,,20\n"
+		"3";
+
+	fcyTextTable::Options tOpt;
+	tOpt.CommentPrefix = "#";
+
+	fcyTextTable tTable;
+	tTable.Parse(s_Text, tOpt);
+	FCY_CHECK(tTable.GetRecordCount() == 4);
+	FCY_CHECK(tTable.GetTotalFieldCount() == 10);
+	FCY_CHECK(tTable.GetField(0, 0) == "id" && tTable.GetField(0, 1) == "name" && tTable.GetField(0, 2) == "value");
+	FCY_CHECK(tTable.GetField(1, 2) == "10");
+	FCY_CHECK(tTable.GetFieldCount(2) == 3 && tTable.GetField(2, 1).empty());
+	FCY_CHECK(tTable.GetFieldCount(3) == 1 && tTable.GetRecord(3)[0] == "3");
+	FCY_CHECK(tTable.GetLineNumber(0) == 1 && tTable.GetLineNumber(1) == 4);
+	FCY_CHECK(tTable.GetLineNumber(2) == 6 && tTable.GetLineNumber(3) == 7);
+
+	// 越界返回空视图
+	FCY_CHECK(tTable.GetField(0, 3).empty() && tTable.GetField(4, 0).empty());
+
+	// 不去除空白、不跳过空行
+	tOpt.TrimFields = false;
+	tOpt.SkipEmptyLines = false;
+	tTable.Parse(s_Text, tOpt);
+	FCY_CHECK(tTable.GetRecordCount() == 6);
+	FCY_CHECK(tTable.GetField(0, 1) == " name ");
+	FCY_CHECK(tTable.GetFieldCount(1) == 1 && tTable.GetField(1, 0).empty());
+	FCY_CHECK(tTable.GetField(3, 0) == "   ");
+
+	// 空分隔符时整行为一个字段
+	tOpt.FieldSeparator.clear();
+	tTable.Parse("a,b\nc", tOpt);
+	FCY_CHECK(tTable.GetRecordCount() == 2 && tTable.GetField(0, 0) == "a,b");
+
+	tTable.Clear();
+	FCY_CHECK(tTable.GetRecordCount() == 0 && tTable.GetTotalFieldCount() == 0);
+}
+
+FCY_TEST(table, Parallel)
+{
+	string tText;
+	for (int i = 0; i < 5000; ++i)
+	{
+		if (i % 7 == 0)
+			tText += "#skip\n";
+		if (i % 11 == 0)
+			tText += "\n";
+		tText += to_string(i) + "\t" + to_string(i * 3) + "\t name" + to_string(i % 13) + "\r\n";
+	}
+
+	fcyTextTable::Options tOpt;
+	tOpt.FieldSeparator = "\t";
+	tOpt.CommentPrefix = "#";
+	tOpt.ThreadCount = 1;
+	fcyTextTable tSingle;
+	tSingle.Parse(tText, tOpt);
+
+	tOpt.ThreadCount = 8;
+	tOpt.MinChunkSize = 1;
+	fcyTextTable tMulti;
+	tMulti.Parse(tText, tOpt);
+
+	FCY_CHECK(tSingle.GetRecordCount() == 5000);
+	FCY_CHECK(tMulti.GetRecordCount() == tSingle.GetRecordCount());
+	FCY_CHECK(tMulti.GetTotalFieldCount() == tSingle.GetTotalFieldCount());
+
+	bool tSame = true;
+	for (size_t i = 0; i < tSingle.GetRecordCount() && tSame; ++i)
+	{
+		tSame = tMulti.GetLineNumber(i) == tSingle.GetLineNumber(i) &&
+			tMulti.GetFieldCount(i) == tSingle.GetFieldCount(i);
+		for (uint32_t j = 0; tSame && j < tSingle.GetFieldCount(i); ++j)
+			tSame = tMulti.GetField(i, j) == tSingle.GetField(i, j);
+	}
+	FCY_CHECK(tSame);
+	FCY_CHECK(tSingle.GetField(4999, 2) == "name" + to_string(4999 % 13));
+}
+
+FCY_TEST(table, LoadFile)
+{
+	const char* tPath = "fcyTest_table.txt";
+	{
+		ofstream tOut(tPath, ios::binary);
+		tOut << "a;b\nc;d;e\n";
+	}
+
+	fcyTextTable::Options tOpt;
+	tOpt.FieldSeparator = ";";
+	fcyTextTable tTable;
+	FCY_CHECK(tTable.LoadFile(tPath, tOpt));
+	FCY_CHECK(tTable.GetRecordCount() == 2 && tTable.GetField(1, 2) == "e");
+
+	// 移动后视图仍指向同一映射
+	fcyTextTable tMoved(move(tTable));
+	FCY_CHECK(tMoved.GetField(0, 1) == "b");
+	tMoved.Clear();
+
+	{
+		ofstream tOut(tPath, ios::binary | ios::trunc);
+	}
+	FCY_CHECK(tMoved.LoadFile(tPath, tOpt));
+	FCY_CHECK(tMoved.GetRecordCount() == 0);
+	tMoved.Clear();
+	remove(tPath);
+
+	FCY_CHECK(!tMoved.LoadFile("fcyTest_missing.txt", tOpt));
+	FCY_CHECK(tMoved.GetRecordCount() == 0);
+}